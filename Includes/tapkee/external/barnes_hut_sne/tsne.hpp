@@ -35,6 +35,8 @@
 /* Tapkee includes */
 #include <tapkee/utils/logging.hpp>
 #include <tapkee/utils/time.hpp>
+#include <tapkee/parameters/context.hpp>
+#include <tapkee/exceptions.hpp>
 #include <tapkee/external/barnes_hut_sne/quadtree.hpp>
 #include <tapkee/external/barnes_hut_sne/vptree.hpp>
 /* End of Tapkee includes */
@@ -57,7 +59,8 @@ static inline ScalarType sign(ScalarType x) { return (x == .0 ? .0 : (x < .0 ? -
 class TSNE
 {
 public:
-	void run(tapkee::DenseMatrix& X, int N, int D, ScalarType* Y, int no_dims, ScalarType perplexity, ScalarType theta)
+	void run(tapkee::DenseMatrix& X, int N, int D, ScalarType* Y, int no_dims, ScalarType perplexity, ScalarType theta,
+	         const tapkee::tapkee_internal::Context* cancel_context = NULL)
 	{
 		// Determine whether we are using an exact algorithm
 		bool exact = (theta == .0) ? true : false;
@@ -129,8 +132,15 @@ public:
 
 		{
 			tapkee::tapkee_internal::timed_context context("Main t-SNE loop");
+			bool cancelled = false;
 			for(int iter = 0; iter < max_iter; iter++) {
 
+				// Check for cancellation between iterations
+				if(cancel_context && cancel_context->is_cancelled()) {
+					cancelled = true;
+					break;
+				}
+
 				// Compute (approximate) gradient
 				if(exact) computeExactGradient(P.data(), Y, N, no_dims, dY.data());
 				else computeGradient(P.data(), row_P, col_P, val_P, Y, N, no_dims, dY.data(), theta);
@@ -173,6 +183,8 @@ public:
 				free(col_P); col_P = NULL;
 				free(val_P); val_P = NULL;
 			}
+			if(cancelled)
+				throw tapkee::cancelled_exception();
 		}
 	}
 
@@ -530,7 +530,7 @@ private:
 
 		DenseMatrix embedding(static_cast<IndexType>(p_target_dimension),n_vectors);
 		tsne::TSNE tsne;
-		tsne.run(data,data.cols(),data.rows(),embedding.data(),p_target_dimension,p_perplexity,p_theta);
+		tsne.run(data,data.cols(),data.rows(),embedding.data(),p_target_dimension,p_perplexity,p_theta,&context);
 
 		return TapkeeOutput(embedding.transpose(), unimplementedProjectingFunction());
 	}
@@ -0,0 +1,191 @@
+//
+//  DDRMAutomationDecimator.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "DDRMSynthControlDescriptors.h"
+#include "DDRMMidiTransmitter.h"
+
+class DDRMAutomationDecimator: private HighResolutionTimer
+
+{
+public:
+    /*
+     Host automation ramps arrive at the parameter update rate of the host (which can be once per audio
+     block per parameter). DDRMAutomationDecimator resamples them to the MIDI control rate before they
+     are queued in the MIDI transmitter:
+     - values are quantised to 0-127 when they arrive and updates which don't change the value are dropped
+     - only the latest value of each control is kept, and it is sent at the next control rate tick
+     - optionally, changes are slew limited to a maximum number of CC steps per tick, so big jumps are
+       spread over a few messages instead of being sent as a single step (or a zipper burst)
+
+     setTargetValue is real-time safe (it only stores atomics) and is called from the audio thread.
+     Ticks run in the high resolution timer thread. Changes sent to the synth through other paths
+     (UI, presets, MIDI input) must be reported with setCurrentValue so slewed ramps start from the
+     value the synth actually has.
+
+     Per control stats count the host updates received, the updates absorbed (dropped because the value
+     did not change or because a newer value arrived before the next tick) and the messages emitted.
+     They are available in all builds with getStats (per control or totals), e.g. for the UI.
+     */
+
+    DDRMAutomationDecimator (DDRMMidiTransmitter* t)
+    {
+        midiTransmitter = t;
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            targetValues[i] = -1;  // -1 = no pending target
+            currentValues[i] = -1;  // -1 = unknown
+        }
+        resetStats();
+        slewLimit = 0;
+        controlRateHz = AUTOMATION_CONTROL_RATE_DEFAULT_HZ;
+        startTimer(1000 / controlRateHz);
+    }
+
+    ~DDRMAutomationDecimator ()
+    {
+        stopTimer();
+    }
+
+    void setControlRate (int hz)
+    {
+        controlRateHz = jlimit(1, 1000, hz);
+        startTimer(1000 / controlRateHz);
+    }
+
+    int getControlRate ()
+    {
+        return controlRateHz;
+    }
+
+    void setSlewLimit (int maxStepsPerTick)
+    {
+        // 0 disables slew limiting
+        slewLimit = jmax(0, maxStepsPerTick);
+    }
+
+    int getSlewLimit ()
+    {
+        return slewLimit;
+    }
+
+    void setTargetValue (int controlIndex, float value)
+    {
+        // Records a value coming from host automation (real-time safe)
+        if ((controlIndex < 0) || (controlIndex >= DDRM_NUM_SYNTH_CONTROLS)){
+            return;
+        }
+        numHostUpdates[controlIndex]++;
+        int ccValue = roundToInt(jlimit(0.0f, 127.0f, value));
+        int previousTarget = targetValues[controlIndex].load();
+        if ((previousTarget < 0) && (ccValue == currentValues[controlIndex].load())){
+            numAbsorbedUpdates[controlIndex]++;  // Unchanged value
+            return;
+        }
+        previousTarget = targetValues[controlIndex].exchange(ccValue);
+        if (previousTarget >= 0){
+            numAbsorbedUpdates[controlIndex]++;  // Previous value was not sent yet, the new one replaces it
+        }
+    }
+
+    void setCurrentValue (int controlIndex, int ccValue)
+    {
+        // To be called when a value is sent to (or received from) the synth outside of automation.
+        // Drops any pending automation target for that control.
+        if ((controlIndex < 0) || (controlIndex >= DDRM_NUM_SYNTH_CONTROLS)){
+            return;
+        }
+        currentValues[controlIndex] = ccValue;
+        targetValues[controlIndex] = -1;
+    }
+
+    // Stats (can be called from any thread, in all builds)
+
+    struct Stats
+    {
+        int numReceived = 0;  // Host updates received
+        int numSent = 0;  // Messages emitted to the MIDI transmitter
+        int numDropped = 0;  // Host updates absorbed (unchanged value or replaced before the next tick)
+    };
+
+    Stats getStats (int controlIndex)
+    {
+        Stats stats;
+        if ((controlIndex >= 0) && (controlIndex < DDRM_NUM_SYNTH_CONTROLS)){
+            stats.numReceived = numHostUpdates[controlIndex];
+            stats.numSent = numEmittedMessages[controlIndex];
+            stats.numDropped = numAbsorbedUpdates[controlIndex];
+        }
+        return stats;
+    }
+
+    Stats getStats ()
+    {
+        // Totals for all controls
+        Stats totals;
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            Stats stats = getStats(i);
+            totals.numReceived += stats.numReceived;
+            totals.numSent += stats.numSent;
+            totals.numDropped += stats.numDropped;
+        }
+        return totals;
+    }
+
+    void resetStats ()
+    {
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            numHostUpdates[i] = 0;
+            numAbsorbedUpdates[i] = 0;
+            numEmittedMessages[i] = 0;
+        }
+    }
+
+private:
+
+    DDRMMidiTransmitter* midiTransmitter;
+    std::atomic<int> controlRateHz;
+    std::atomic<int> slewLimit;
+    std::array<std::atomic<int>, DDRM_NUM_SYNTH_CONTROLS> targetValues;
+    std::array<std::atomic<int>, DDRM_NUM_SYNTH_CONTROLS> currentValues;
+    std::array<std::atomic<int>, DDRM_NUM_SYNTH_CONTROLS> numHostUpdates;
+    std::array<std::atomic<int>, DDRM_NUM_SYNTH_CONTROLS> numAbsorbedUpdates;
+    std::array<std::atomic<int>, DDRM_NUM_SYNTH_CONTROLS> numEmittedMessages;
+
+    void hiResTimerCallback () override
+    {
+        // Control rate tick: send one message per control with a pending target
+        int maxStep = slewLimit;
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            int target = targetValues[i].load();
+            if (target < 0){
+                continue;
+            }
+            int current = currentValues[i].load();
+            int next = target;
+            if ((maxStep > 0) && (current >= 0)){
+                next = current + jlimit(-maxStep, maxStep, target - current);
+            }
+            if (next != current){
+                midiTransmitter->enqueueControlChange(ddrmSynthControlDescriptors[i].ccNumber, next);
+                currentValues[i] = next;
+                numEmittedMessages[i]++;
+            }
+            if (next == target){
+                // Target reached, clear it unless a newer one arrived in the meantime
+                targetValues[i].compare_exchange_strong(target, -1);
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMAutomationDecimator)
+};
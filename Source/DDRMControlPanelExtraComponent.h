@@ -161,11 +161,11 @@ public:
         } else if (actionID == MENU_OPTION_ID_SWAP_VOICES){
             processor->swapDDRMChannels();
         } else if (actionID == MENU_OPTION_ID_SEND_PATCH_TO_SYNTH){
-            processor->sendControlsToSynth(0);  // 0 menans no channel filter
+            processor->sendControlsToSynth(0, true);  // 0 menans no channel filter, force sending all values
         } else if (actionID == MENU_OPTION_ID_SEND_VOICE_1_TO_SYNTH){
-            processor->sendControlsToSynth(1);
+            processor->sendControlsToSynth(1, true);
         } else if (actionID == MENU_OPTION_ID_SEND_VOICE_2_TO_SYNTH){
-            processor->sendControlsToSynth(2);
+            processor->sendControlsToSynth(2, true);
         } else if (actionID == MENU_OPTION_ID_RANDOMIZE_PATCH_5_ID){
             processor->randomizeControlValues(0, 0.05);
         } else if (actionID == MENU_OPTION_ID_RANDOMIZE_PATCH_10_ID){
@@ -0,0 +1,214 @@
+//
+//  DDRMEventBus.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "DDRMRealtimeTripwire.h"
+
+enum class DDRMEvent
+{
+    // Timbre space engine -> timbre space component
+    loadTimbreSpaceSolution = 0,
+    setIsComputingTimbreSpaceSolution,
+    loadSelectedPointData,
+    repaintTimbreSpace,
+    setTimbreSpaceSlidersOutOfSync,
+    setTimbreSpaceSlidersInSync,
+    setTimbreSpaceXYToPresetNumber,
+
+    // Timbre space engine -> processor
+    loadInterpolatedPreset,
+    timbreSpaceSolutionComputed,
+    timbreSpaceRasterBuilt,
+
+    // DDRM interface -> tone selector component
+    setToneSelectorButtonsRow1Off,
+    setToneSelectorButtonsRow2Off,
+    setToneSelectorButtonsRow1,
+    setToneSelectorButtonsRow2,
+
+    // Processor -> preset control component
+    setCurrentPresetName,
+    setCurrentPresetNameOutOfSync,
+    setCurrentPresetNameInSync,
+    currentPresetSavedToBank,
+    bankFileLoaded,
+
+    // Processor -> MIDI settings component and editor
+    updatedMidiDeviceSettings,
+    refreshMidiDeviceLists,
+    midiEnableAutoScan,
+    midiDisableAutoScan,
+    midiTriggerDeviceScan,
+    updateUIScaleFactor,
+
+    numEvents
+};
+
+#define DDRM_NUM_EVENTS ((int)DDRMEvent::numEvents)
+
+class DDRMEventListener
+{
+public:
+    virtual ~DDRMEventListener () {}
+
+    virtual void ddrmEventCallback (DDRMEvent event) = 0;
+};
+
+class DDRMEventBus: private AsyncUpdater
+
+{
+public:
+    /*
+     DDRMEventBus replaces string ActionBroadcaster messages for the notifications exchanged between
+     the processor, the timbre space engine, the DDRM interface and the UI components. Events are
+     values of the DDRMEvent enum and carry no payload (listeners read whatever they need from the
+     object which sent the event), so posting an event does not allocate.
+
+     Listeners subscribe to the specific event types they handle and are stored in one list per
+     event type, so dispatching an event only calls the listeners interested in it. List storage is
+     preallocated when the bus is created.
+
+     postEvent can be called from any thread: it marks the event as pending and triggers an async
+     update which dispatches pending events in the message thread. If an event is posted again
+     before being dispatched, both posts are coalesced into a single callback. Pending events are
+     dispatched in the order of their last post, so for pairs of events like "out of sync"/"in sync"
+     listeners always end up in the state of the last one posted.
+
+     sendEventNow dispatches the event synchronously when called from the message thread (and
+     falls back to postEvent otherwise). This is used for the processor-internal events which
+     don't need to go through the message queue.
+     */
+
+    DDRMEventBus ()
+    {
+        nextSequenceNumber = 0;
+        for (int i=0; i<DDRM_NUM_EVENTS; i++){
+            pendingEventSequenceNumbers[i] = 0;  // 0 = event not pending
+            listeners[i].ensureStorageAllocated(DDRM_EVENT_BUS_LISTENERS_PER_EVENT);
+        }
+    }
+
+    virtual ~DDRMEventBus ()
+    {
+        cancelPendingUpdate();
+        removeAllEventListeners();
+    }
+
+    void addEventListener (DDRMEventListener* listener, std::initializer_list<DDRMEvent> events)
+    {
+        // Subscribe listener to the given event types
+        jassert (listener != nullptr);
+        const ScopedLock sl (listenersLock);
+        for (DDRMEvent event: events){
+            listeners[(int)event].addIfNotAlreadyThere(listener);
+        }
+    }
+
+    void addEventListener (DDRMEventListener* listener)
+    {
+        // Subscribe listener to all event types
+        jassert (listener != nullptr);
+        const ScopedLock sl (listenersLock);
+        for (int i=0; i<DDRM_NUM_EVENTS; i++){
+            listeners[i].addIfNotAlreadyThere(listener);
+        }
+    }
+
+    void removeEventListener (DDRMEventListener* listener)
+    {
+        // Unsubscribe listener from all event types
+        const ScopedLock sl (listenersLock);
+        for (int i=0; i<DDRM_NUM_EVENTS; i++){
+            listeners[i].removeFirstMatchingValue(listener);
+        }
+    }
+
+    void removeAllEventListeners ()
+    {
+        const ScopedLock sl (listenersLock);
+        for (int i=0; i<DDRM_NUM_EVENTS; i++){
+            listeners[i].clearQuick();
+        }
+    }
+
+    void postEvent (DDRMEvent event)
+    {
+        // Mark event as pending (or move it to the end of the pending events if it was already pending)
+        // and dispatch it asynchronously in the message thread
+        DDRM_ASSERT_NOT_REALTIME  // Triggering the async update posts a message to the message queue
+        uint32 sequenceNumber = ++nextSequenceNumber;
+        if (sequenceNumber == 0){
+            sequenceNumber = ++nextSequenceNumber;  // Skip 0 as it means "not pending"
+        }
+        pendingEventSequenceNumbers[(int)event].store(sequenceNumber);
+        triggerAsyncUpdate();
+    }
+
+    void sendEventNow (DDRMEvent event)
+    {
+        // Dispatch event synchronously if in the message thread, otherwise post it
+        if (MessageManager::existsAndIsCurrentThread()){
+            pendingEventSequenceNumbers[(int)event].store(0);  // Drop any pending post of the same event
+            dispatchEvent(event);
+        } else {
+            postEvent(event);
+        }
+    }
+
+private:
+
+    std::array<Array<DDRMEventListener*>, DDRM_NUM_EVENTS> listeners;
+    CriticalSection listenersLock;
+    std::array<std::atomic<uint32>, DDRM_NUM_EVENTS> pendingEventSequenceNumbers;
+    std::atomic<uint32> nextSequenceNumber;
+
+    void handleAsyncUpdate () override
+    {
+        // Collect pending events and dispatch them in the order in which they were (last) posted
+        std::array<std::pair<uint32, int>, DDRM_NUM_EVENTS> pendingEvents;
+        int numPendingEvents = 0;
+        for (int i=0; i<DDRM_NUM_EVENTS; i++){
+            uint32 sequenceNumber = pendingEventSequenceNumbers[i].exchange(0);
+            if (sequenceNumber != 0){
+                // Insertion sort by sequence number (there are only a few events pending at a time)
+                int j = numPendingEvents;
+                while ((j > 0) && (pendingEvents[j - 1].first > sequenceNumber)){
+                    pendingEvents[j] = pendingEvents[j - 1];
+                    j--;
+                }
+                pendingEvents[j] = std::make_pair(sequenceNumber, i);
+                numPendingEvents++;
+            }
+        }
+
+        for (int i=0; i<numPendingEvents; i++){
+            dispatchEvent((DDRMEvent)pendingEvents[i].second);
+        }
+    }
+
+    void dispatchEvent (DDRMEvent event)
+    {
+        // Call listeners subscribed to the event. Iterate backwards and re-check bounds so listeners can
+        // remove themselves (or others) from inside the callback.
+        const ScopedLock sl (listenersLock);
+        Array<DDRMEventListener*>& eventListeners = listeners[(int)event];
+        for (int i=eventListeners.size(); --i >= 0;){
+            if (i < eventListeners.size()){
+                eventListeners.getUnchecked(i)->ddrmEventCallback(event);
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMEventBus)
+};
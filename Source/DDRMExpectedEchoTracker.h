@@ -0,0 +1,206 @@
+//
+//  DDRMExpectedEchoTracker.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+
+class DDRMExpectedEchoTracker
+
+{
+public:
+    /*
+     The DDRM replicates every MIDI message it receives to its MIDI output. When the plugin sends a CC to
+     the synth, the same CC comes back through the MIDI input and should be ignored (otherwise it would be
+     applied again to the parameter and possibly sent back to the synth). DDRMExpectedEchoTracker keeps a
+     small ring of "expected echoes" per CC number: the (value, send time) pairs of the messages sent by
+     the MIDI transmitter which have not come back yet.
+
+     An incoming CC is considered an echo (and consumed) only if it matches the value of an expected echo
+     for that CC number sent within the echo window. Anything else is a genuine change made on the synth.
+     Echoes come back in the order they were sent, so when an echo is matched, older expected echoes for
+     the same CC number are discarded.
+
+     The echo window adapts to the measured round trip latency of the link (smoothed average of the
+     matched echo delays, scaled by MIDI_ECHO_WINDOW_LATENCY_FACTOR and clamped to
+     [MIDI_ECHO_WINDOW_MIN_MS, MIDI_ECHO_WINDOW_MAX_MS]).
+
+     Expected echoes which are not matched within the echo window are lost messages. When echo
+     acknowledgement is enabled in the MIDI transmitter, it periodically collects them with
+     collectLostEchoes so it can resend them. Each expected echo stores how many times its value has
+     already been resent to limit resends.
+
+     Calls to addExpectedEcho must be serialized: the MIDI transmitter only calls it from the thread which
+     is consuming its queue (its own thread, or the audio thread in host output mode), and isConsumingQueue
+     ensures there is only one at a time. consumeExpectedEcho must only be called from a single thread (the
+     MIDI input thread). No locks are used: each slot is an atomic word packing the send time, the resend
+     count and the value, and consumed/lost slots are cleared with compare-and-swap.
+     */
+
+    DDRMExpectedEchoTracker ()
+    {
+        for (int i=0; i<writePositions.size(); i++){
+            writePositions[i] = 0;
+        }
+        clear();
+        estimatedEchoLatencyMs = MIDI_ECHO_INITIAL_LATENCY_ESTIMATE_MS;
+        numConsumedEchoes = 0;
+    }
+
+    ~DDRMExpectedEchoTracker ()
+    {
+    }
+
+    void clear ()
+    {
+        for (int i=0; i<expectedEchoes.size(); i++){
+            for (int j=0; j<MIDI_ECHO_SLOTS_PER_CC; j++){
+                expectedEchoes[i][j] = 0;  // 0 = empty slot
+            }
+        }
+    }
+
+    void addExpectedEcho (int ccNumber, int ccValue, uint32 sendTime, int resendCount=0)
+    {
+        // Records that a CC message was just sent to the synth (MIDI transmitter thread)
+        if ((ccNumber < 0) || (ccNumber >= expectedEchoes.size())){
+            return;
+        }
+        int& position = writePositions[ccNumber];
+        expectedEchoes[ccNumber][position] = packExpectedEcho(ccValue, sendTime, resendCount);  // Overwrites oldest slot if ring is full
+        position = (position + 1) % MIDI_ECHO_SLOTS_PER_CC;
+    }
+
+    bool consumeExpectedEcho (int ccNumber, int ccValue, uint32 receiveTime)
+    {
+        // Returns true if the incoming CC message is the echo of a message sent by the plugin (MIDI input thread)
+        if ((ccNumber < 0) || (ccNumber >= expectedEchoes.size())){
+            return false;
+        }
+
+        uint32 windowMs = getEchoWindowMs();
+        int matchedSlot = -1;
+        uint64 matchedEcho = 0;
+        uint32 matchedElapsedMs = 0;
+        for (int i=0; i<MIDI_ECHO_SLOTS_PER_CC; i++){
+            uint64 echo = expectedEchoes[ccNumber][i];
+            if (echo == 0){
+                continue;
+            }
+            uint32 elapsedMs = receiveTime - getSendTime(echo);  // Unsigned arithmetic handles counter wrap around
+            if (elapsedMs > windowMs){
+                continue;  // Expired, the echo got lost (see collectLostEchoes)
+            }
+            if ((getValue(echo) == ccValue) && ((matchedSlot < 0) || (elapsedMs > matchedElapsedMs))){
+                // Match the oldest expected echo with that value
+                matchedSlot = i;
+                matchedEcho = echo;
+                matchedElapsedMs = elapsedMs;
+            }
+        }
+
+        if ((matchedSlot < 0) || (!expectedEchoes[ccNumber][matchedSlot].compare_exchange_strong(matchedEcho, 0))){
+            return false;  // Not an echo, genuine change made on the synth
+        }
+
+        // Discard expected echoes sent before the matched one
+        for (int i=0; i<MIDI_ECHO_SLOTS_PER_CC; i++){
+            uint64 echo = expectedEchoes[ccNumber][i];
+            if ((echo != 0) && ((uint32)(receiveTime - getSendTime(echo)) > matchedElapsedMs)){
+                expectedEchoes[ccNumber][i].compare_exchange_strong(echo, 0);
+            }
+        }
+
+        // Update round trip latency estimate (exponential moving average)
+        float estimate = estimatedEchoLatencyMs;
+        estimatedEchoLatencyMs = estimate + MIDI_ECHO_LATENCY_SMOOTHING * ((float)matchedElapsedMs - estimate);
+        numConsumedEchoes++;
+        return true;
+    }
+
+    template <typename LostEchoCallback>
+    int collectLostEchoes (uint32 now, LostEchoCallback&& onLostEcho)
+    {
+        // Clears expected echoes that were not received within the echo window and calls
+        // onLostEcho (ccNumber, ccValue, resendCount) for each of them. Returns the number of lost echoes.
+        uint32 windowMs = getEchoWindowMs();
+        int numLostEchoes = 0;
+        for (int ccNumber=0; ccNumber<expectedEchoes.size(); ccNumber++){
+            for (int i=0; i<MIDI_ECHO_SLOTS_PER_CC; i++){
+                uint64 echo = expectedEchoes[ccNumber][i];
+                if ((echo != 0) && ((uint32)(now - getSendTime(echo)) > windowMs)){
+                    if (expectedEchoes[ccNumber][i].compare_exchange_strong(echo, 0)){
+                        numLostEchoes++;
+                        onLostEcho(ccNumber, getValue(echo), getResendCount(echo));
+                    }
+                }
+            }
+        }
+        return numLostEchoes;
+    }
+
+    uint32 getEchoWindowMs ()
+    {
+        return (uint32)jlimit((float)MIDI_ECHO_WINDOW_MIN_MS, (float)MIDI_ECHO_WINDOW_MAX_MS,
+                              estimatedEchoLatencyMs * MIDI_ECHO_WINDOW_LATENCY_FACTOR);
+    }
+
+    float getEstimatedEchoLatencyMs ()
+    {
+        return estimatedEchoLatencyMs;
+    }
+
+    void setEstimatedEchoLatencyMs (float latencyMs)
+    {
+        estimatedEchoLatencyMs = jmax(0.0f, latencyMs);
+    }
+
+    int getNumConsumedEchoes ()
+    {
+        return numConsumedEchoes;
+    }
+
+    void resetStats ()
+    {
+        numConsumedEchoes = 0;
+    }
+
+private:
+
+    std::array<std::array<std::atomic<uint64>, MIDI_ECHO_SLOTS_PER_CC>, 128> expectedEchoes;  // Packed (send time, resend count, value) per slot
+    std::array<int, 128> writePositions;  // Only accessed by the thread calling addExpectedEcho
+    std::atomic<float> estimatedEchoLatencyMs;
+    std::atomic<int> numConsumedEchoes;
+
+    static uint64 packExpectedEcho (int ccValue, uint32 sendTime, int resendCount)
+    {
+        // Bits 0-6: value, bit 7: always set so a packed echo is never 0 (empty slot), bits 8-15: resend count,
+        // bits 16-47: send time
+        return ((uint64)sendTime << 16) | ((uint64)(resendCount & 0xff) << 8) | 0x80 | (uint64)(ccValue & 0x7f);
+    }
+
+    static uint32 getSendTime (uint64 echo)
+    {
+        return (uint32)(echo >> 16);
+    }
+
+    static int getResendCount (uint64 echo)
+    {
+        return (int)((echo >> 8) & 0xff);
+    }
+
+    static int getValue (uint64 echo)
+    {
+        return (int)(echo & 0x7f);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMExpectedEchoTracker)
+};
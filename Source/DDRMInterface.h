@@ -11,11 +11,14 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "DDRMSynthControl.h"
+#include "DDRMSynthControlDescriptors.h"
 #include "DDRMPresetBank.h"
 #include "DDRMToneSelectorPresets.h"
+#include "DDRMEventBus.h"
 #include "defines.h"
 
-class DDRMInterface: public ActionBroadcaster
+class DDRMInterface: public ActionBroadcaster,
+                     public DDRMEventBus
 
 {
 public:
@@ -31,132 +34,99 @@ public:
         removeAllActionListeners();
     }
     
-    void loadSynthControlObjects() {
-        // Add DDRMSynthControl objects to the synthControls vector
-        // --> Start auto-generated code A
-        synthControls.push_back(DDRMSynthControl("DDRM_SPEED_VCO_1", "Ch I: PWM Speed", 40, 0, 0, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_PWM_VCO_1", "Ch I: PWM Amount", 41, 1, 1, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_PW_VCO_1", "Ch I: PW", 42, 2, 2, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SQR_VCO_1", "Ch I: Square", 43, 73, 24, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SAW_VCO_1", "Ch I: Sawtooth", 44, 74, 25, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_NOISE_VCO_1", "Ch I: Noise", 45, 3, 3, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_HPF_VCF_1", "Ch I: HPF", 46, 4, 4, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_RESh_VCF_1", "Ch I: RESh", 47, 5, 5, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_LPF_VCF_1", "Ch I: LPF", 48, 6, 6, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_RESl_VCF_1", "Ch I: RESl", 49, 7, 7, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_IL_VCF_1", "Ch I: VCF IL", 50, 8, 8, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_AL_VCF_1", "Ch I: VCF AL", 51, 9, 9, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_A_VCF_1", "Ch I: VCF A", 52, 10, 10, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_D_VCF_1", "Ch I: VCF D", 53, 11, 11, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_R_VCF_1", "Ch I: VCF R", 54, 12, 12, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_VCF_VCA_1", "Ch I: VCF Level", 55, 13, 13, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SINE__VCA_1", "Ch I: Sine Level", 56, 14, 14, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_A_VCA_1", "Ch I: VCA A", 57, 15, 15, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_D_VCA_1", "Ch I: VCA D", 58, 16, 16, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_S_VCA_1", "Ch I: VCA S", 59, 17, 17, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_R_VCA_1", "Ch I: VCA R", 60, 18, 18, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_LEVEL_VCA_1", "Ch I: Channel Level", 61, 19, 19, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_INIT_BR_TOUCH_1", "Ch I: Initial Brilliance", 62, 20, 20, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_INIT_LEV_TOUCH_1", "Ch I: Initial Level", 63, 21, 21, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_AT_BR_TOUCH_1", "Ch I: After Brilliance", 65, 22, 22, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_AT_LEV_TOUCH_1", "Ch I: After Level", 66, 23, 23, 1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SPEED_VCO_2", "Ch II: PWM Speed", 67, 30, 0, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_PWM_VCO_2", "Ch II: PWM Amount", 68, 31, 1, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_PW_VCO_2", "Ch II: PW", 69, 32, 2, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SQR_VCO_2", "Ch II: Square", 70, 76, 24, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SAW_VCO_2", "Ch II: Sawtooth", 71, 75, 25, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_NOISE_VCO_2", "Ch II: Noise", 72, 33, 3, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_HPF_VCF_2", "Ch II: HPF", 73, 34, 4, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_RESh_VCF_2", "Ch II: RESh", 119, 35, 5, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_LPF_VCF_2", "Ch II: LPF", 75, 36, 6, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_RESl_VCF_2", "Ch II: RESl", 76, 37, 7, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_IL_VCF_2", "Ch II: VCF IL", 77, 38, 8, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_AL_VCF_2", "Ch II: VCF AL", 78, 39, 9, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_A_VCF_2", "Ch II: VCF A", 79, 24, 10, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_D_VCF_2", "Ch II: VCF D", 80, 25, 11, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_R_VCF_2", "Ch II: VCF R", 81, 26, 12, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_VCF_VCA_2", "Ch II: VCF Level", 82, 27, 13, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SINE__VCA_2", "Ch II: Sine Level", 83, 28, 14, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_A_VCA_2", "Ch II: VCA A", 84, 29, 15, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_D_VCA_2", "Ch II: VCA D", 85, 40, 16, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_S_VCA_2", "Ch II: VCA S", 86, 41, 17, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_R_VCA_2", "Ch II: VCA R", 87, 42, 18, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_LEVEL_VCA_2", "Ch II: Channel Level", 88, 43, 19, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_INIT_BR_TOUCH_2", "Ch II: Initial Brilliance", 89, 44, 20, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_INIT_LEV_TOUCH_2", "Ch II: Initial Level", 90, 45, 21, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_AT_BR_TOUCH_2", "Ch II: After Brilliance", 91, 46, 22, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_AT_LEV_TOUCH_2", "Ch II: After Level", 92, 47, 23, 2, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_COARSE_PITCH", "Pitch Coarse", 93, 77, -1, -1, false));
-        synthControls.push_back(DDRMSynthControl("DDRM_FINE_PITCH", "Pitch Fine", 94, 78, -1, -1, false));
-        synthControls.push_back(DDRMSynthControl("DDRM_DETUNE_CH2_PITCH", "Detune Ch II", 95, 79, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_FEET_1_FEET", "Feet I", 102, 48, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_FEET_2_FEET", "Feet II", 103, 49, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_FUNCTION_SUB_OSC", "Sub Osc Function", 104, 50, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SPEED_SUB_OSC", "Sub Osc Speed", 105, 51, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_VCO_SUB_OSC", "Sub Osc VCO Amount", 106, 52, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_VCF_SUB_OSC", "Sub Osc VCF Amount", 107, 53, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_VCA_SUB_OSC", "Sub Osc VCA Amount", 108, 54, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_MIX", "Mix", 8, 55, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_BRILL", "Brilliance", 109, 56, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_RESSO", "Ressonance", 110, 57, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_INITIAL_TOUCH", "Initial Pitch Bend", 111, 58, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SPEED_TOUCH", "Touch Response Sub Osc Speed", 112, 59, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_VCO_TOUCH", "Touch Response Sub Osc VCO Amount", 113, 60, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_VCF_TOUCH", "Touch Response Sub Osc VCF Amount", 114, 61, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_BR_LOW_KBRD", "Brilliance Low", 115, 62, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_BR_HIGH_KBRD", "Brilliance High", 116, 63, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_LEV_LOW_KBRD", "Level Low", 117, 64, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_LEV_HIGH_KBRD", "Level High", 118, 65, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_GLIDE_MODE_GLIDE", "Glide Mode", 39, -1, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_GLIDE_TIME_GLIDE", "Glide Time", 5, 66, -1, -1, true));
-        synthControls.push_back(DDRMSynthControl("DDRM_SUSTAIN_MODE", "Sustain Mode", 9, -1, -1, -1, false));
-        synthControls.push_back(DDRMSynthControl("DDRM_SUSTAIN_TIME", "Sustain Time", 11, -1, -1, -1, false));
-        // --> End auto-generated code A
+    void loadSynthControlObjects(AudioProcessorValueTreeState* parameters) {
+        // Add DDRMSynthControl objects to the synthControls vector (one per entry in the descriptors table)
+        synthControls.clear();
+        synthControls.reserve(DDRM_NUM_SYNTH_CONTROLS);
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            synthControls.push_back(DDRMSynthControl(ddrmSynthControlDescriptors[i]));
+        }
+        
+        buildControlIndexTables(parameters);
+        buildCCDispatchTable();
         
         #if JUCE_DEBUG
             logMessage(String::formatted("Loaded %i DDRM controls", synthControls.size()));
         #endif
     }
     
+    // Index-based access to synth controls
+    // Synth controls are identified by a dense index (0..N-1) which corresponds to their position in the
+    // synthControls vector. Index tables are built once in loadSynthControlObjects.
+    
+    int getNumSynthControls ()
+    {
+        return (int)synthControls.size();
+    }
+    
+    int getControlIndexForID (const String& synthControlID)
+    {
+        // Returns the index of the DDRMSynthControl with the requested ID, or -1 if it does not exist
+        if (controlIndexesByID.contains(synthControlID)){
+            return controlIndexesByID[synthControlID];
+        }
+        return -1;
+    }
+    
+    DDRMSynthControl& getDDRMSynthControlAtIndex (int controlIndex)
+    {
+        return synthControls[controlIndex];
+    }
+    
+    RangedAudioParameter* getParameterForControlIndex (int controlIndex)
+    {
+        // Returns the audio parameter associated with the synth control at the given index
+        return controlParameters[controlIndex];
+    }
+    
+    const std::vector<int>& getControlIndexes ()
+    {
+        // Returns the indexes of all synth controls
+        return allControlIndexes;
+    }
+    
+    const std::vector<int>& getControlIndexesForChannel (int channel)
+    {
+        // Returns the indexes of the synth controls of a specific channel (controls not belonging to
+        // channel 1 or 2 are returned for any other channel number)
+        if (channel == 1){
+            return channel1ControlIndexes;
+        } else if (channel == 2){
+            return channel2ControlIndexes;
+        }
+        return otherChannelControlIndexes;
+    }
+    
+    const std::vector<int>& getControlIndexesForTimbreSpace ()
+    {
+        // Returns the indexes of the synth controls to be included in the timbre space
+        return timbreSpaceControlIndexes;
+    }
+    
+    // String-based access to synth controls (compatibility layer on top of the index-based access)
+    
     std::vector<String> getDDRMSynthControlIDs (){
         // Returns a vector with all synth control IDs
-        std::vector<String> synthControlIDS;
-        for (int i=0; i < synthControls.size(); i++){
-            synthControlIDS.push_back(synthControls[i].getID());
-        }
-        return synthControlIDS;
+        return getDDRMSynthControlIDsForControlIndexes(allControlIndexes);
     }
     
     std::vector<String> getDDRMSynthControlIDsForChannel (int channel){
         // Returns a vector with all synth control IDs for a specific channel
-        std::vector<String> synthControlIDS;
-        for (int i=0; i < synthControls.size(); i++){
-            if (synthControls[i].getChannelNumber() == channel){
-                synthControlIDS.push_back(synthControls[i].getID());
-            }
-        }
-        return synthControlIDS;
+        return getDDRMSynthControlIDsForControlIndexes(getControlIndexesForChannel(channel));
     }
     
     std::vector<String> getDDRMSynthControlIDsForTimbreSpace (){
         // Returns a vector with all synth control IDs to be included in the timbre space
-        std::vector<String> synthControlIDS;
-        for (int i=0; i < synthControls.size(); i++){
-            if (synthControls[i].shouldBeIncludedInTimbreSpace()){
-                synthControlIDS.push_back(synthControls[i].getID());
-            }
-        }
-        return synthControlIDS;
+        return getDDRMSynthControlIDsForControlIndexes(timbreSpaceControlIndexes);
     }
     
     DDRMSynthControl* getDDRMSynthControlWithID(const String& synthControlID)
     {
         // Returns a reference to a DDRMSynthControl with the requested ID
         // Throws an exception if no DDRMSynthControl exists with such ID
-        for (int i=0; i < synthControls.size(); i++){
-            if (synthControls[i].getID() == synthControlID){
-                return &synthControls[i];
-            }
+        int controlIndex = getControlIndexForID(synthControlID);
+        if (controlIndex > -1){
+            return &synthControls[controlIndex];
         }
         throw std::invalid_argument("No DDRMSynthConrol with ID \"" + synthControlID.toStdString() + "\"");
     }
@@ -165,10 +135,9 @@ public:
     {
         // Returns a reference to a DDRMSynthControl with the requested Control Change number
         // Throws an exception if no DDRMSynthControl exists with such Control Change number
-        for (int i=0; i < synthControls.size(); i++){
-            if (synthControls[i].getCCNumber() == ccNumber){
-                return &synthControls[i];
-            }
+        int controlIndex = getCCDispatchEntry(ccNumber).controlIndex;
+        if (controlIndex > -1){
+            return &synthControls[controlIndex];
         }
         throw std::invalid_argument("No DDRMSynthConrol with CC number \"" + std::to_string(ccNumber) + "\"");
     }
@@ -198,6 +167,17 @@ public:
         return getDDRMSynthControlWithCCNumber(ccNumber)->getID();
     }
     
+    const CCDispatchEntry& getCCDispatchEntry (int ccNumber)
+    {
+        // Returns the audio parameter and synth control index assigned to the given control change number
+        // This is meant to be used in the MIDI input thread so it does no string comparison, allocation or throw
+        // If no DDRMSynthControl exists with assigned ccNumber, the returned entry has parameter set to nullptr
+        if ((ccNumber < 0) || (ccNumber >= ccDispatchTable.size())){
+            return unassignedCCDispatchEntry;
+        }
+        return ccDispatchTable[ccNumber];
+    }
+    
     const String getSynthControlDisaplayNameFromParameterID (const String& parameterID)
     {
         // Gets the synth control name that corresponds to a synth control assigned to the given parameterID
@@ -206,66 +186,89 @@ public:
         return getDDRMSynthControlWithID(parameterID)->getDisplayName();
     }
     
-    SynthControlIdValuePairs getSynthControlIdValuePairsForPresetBytesArray(DDRMPresetBytes& presetBytes)
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsForPresetBytesArray(DDRMPresetBytes& presetBytes)
     {
-        // Returns a list of pairs of DDRMSynthControl and the value they should take to load a specific presetBytes
-        SynthControlIdValuePairs idValuePairs;
-        for (int i=0; i < synthControls.size(); i++){
-            DDRMSynthControl synthControl = synthControls[i];
-            idValuePairs.emplace_back(synthControl.getID(), synthControl.getNormValueFromPresetByteArray(presetBytes));
+        // Returns a list of pairs of DDRMSynthControl index and the value they should take to load a specific presetBytes
+        std::array<double, DDRM_NUM_SYNTH_CONTROLS> normValues;
+        DDRMPresetDecoder::getNormValues(presetBytes, normValues);
+        SynthControlIndexValuePairs indexValuePairs;
+        indexValuePairs.reserve(DDRM_NUM_SYNTH_CONTROLS);
+        for (int i=0; i < DDRM_NUM_SYNTH_CONTROLS; i++){
+            indexValuePairs.emplace_back(i, normValues[i]);
         }
-        return idValuePairs;
+        return indexValuePairs;
     }
     
-    SynthControlIdValuePairs getSynthControlIdValuePairsForVoiceBytesArray(DDRMVoiceBytes& voiceBytes, int channelTo)
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsForVoiceBytesArray(DDRMVoiceBytes& voiceBytes, int channelTo)
     {
-        // Returns a list of pairs of DDRMSynthControl and the value they should take to load a specific voiceBytes
-        std::vector<String> channelControlIDs = getDDRMSynthControlIDsForChannel(channelTo);
-        SynthControlIdValuePairs idValuePairs;
-        for (int i=0; i<channelControlIDs.size(); i++){
-            String controlID = channelControlIDs[i];
-            DDRMSynthControl* synthControl =  getDDRMSynthControlWithID(controlID);
-            double value = synthControl->getNormValueFromVoiceByteArray(voiceBytes);
-            idValuePairs.emplace_back(controlID, value);
+        // Returns a list of pairs of DDRMSynthControl index and the value they should take to load a specific voiceBytes
+        const std::vector<int>& channelControlIndexes = getControlIndexesForChannel(channelTo);
+        SynthControlIndexValuePairs indexValuePairs;
+        indexValuePairs.reserve(channelControlIndexes.size());
+        for (int i=0; i<channelControlIndexes.size(); i++){
+            int controlIndex = channelControlIndexes[i];
+            double value = synthControls[controlIndex].getNormValueFromVoiceByteArray(voiceBytes);
+            indexValuePairs.emplace_back(controlIndex, value);
         }
-        return idValuePairs;
+        return indexValuePairs;
     }
     
-    SynthControlIdValuePairs getSynthControlIdValuePairsForPresetAtIndex(int index)
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsForPresetAtIndex(int index)
     {
-        // Returns a list of pairs of DDRMSynthControl and the value they should take to load a specific preset
-        DDRMPresetBytes& presetBytes = presetBank.getPresetBytesAtIndex(index);
-        return getSynthControlIdValuePairsForPresetBytesArray(presetBytes);
+        // Returns a list of pairs of DDRMSynthControl index and the value they should take to load a specific preset
+        const float* normValues = presetBank.getCachedNormValuesAtIndex(index);
+        SynthControlIndexValuePairs indexValuePairs;
+        indexValuePairs.reserve(DDRM_NUM_SYNTH_CONTROLS);
+        for (int i=0; i < DDRM_NUM_SYNTH_CONTROLS; i++){
+            indexValuePairs.emplace_back(i, normValues[i]);
+        }
+        return indexValuePairs;
     }
     
-    SynthControlIdValuePairs getSynthControlIdValuePairsForInterpolatedPresets(PresetDistancePairsToInterpolate interpolationData)
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsForInterpolatedPresets(PresetDistancePairsToInterpolate interpolationData)
     {
-        // Returns a list of pairs of DDRMSynthControl and the value they should take to load a new preset which is
+        // Returns a list of pairs of DDRMSynthControl index and the value they should take to load a new preset which is
         // created after the interpolation of N presets and distances.
         // Interpolation is done by computing a weight for each preset (based on distance) and linearly summing the
         // each synth control vlaue of the preset multiplied by the weight.
         
         // Calculate total distance and pre-fetch preset bytes
         float totalDistance = 0.0;
-        std::vector<DDRMPresetBytes> presetsBytes;
+        std::vector<DDRMPresetBytes*> presetsBytes;
         for (int i=0;i<interpolationData.size(); i++){
             totalDistance += interpolationData[i].presetDist;
-            presetsBytes.push_back(presetBank.getPresetBytesAtIndex(interpolationData[i].presetIdx));
+            presetsBytes.push_back(&presetBank.getPresetBytesAtIndex(interpolationData[i].presetIdx));
         }
         
         // Interpolate synth control values
-        SynthControlIdValuePairs idValuePairs;
-        std::vector<String> controlIDs = getDDRMSynthControlIDsForTimbreSpace();
-        for (int i=0; i < controlIDs.size(); i++){
-            DDRMSynthControl* synthControl = getDDRMSynthControlWithID(controlIDs[i]);
+        SynthControlIndexValuePairs indexValuePairs;
+        indexValuePairs.reserve(timbreSpaceControlIndexes.size());
+        for (int i=0; i < timbreSpaceControlIndexes.size(); i++){
+            int controlIndex = timbreSpaceControlIndexes[i];
+            DDRMSynthControl& synthControl = synthControls[controlIndex];
             double newValue = 0.0;
             for (int j=0;j<interpolationData.size(); j++){
-                double normValuePreset = (double)synthControl->getNormValueFromPresetByteArray(presetsBytes[j]);
+                double normValuePreset = (double)synthControl.getNormValueFromPresetByteArray(*presetsBytes[j]);
                 newValue += normValuePreset * (double)(interpolationData[j].presetDist/totalDistance);
             }
-            idValuePairs.emplace_back(synthControl->getID(), newValue);
+            indexValuePairs.emplace_back(controlIndex, newValue);
         }
-        return idValuePairs;
+        return indexValuePairs;
+    }
+    
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsForToneSelectorPreset(const String& toneSelectorPresetName, int ddrmChannel)
+    {
+        // Returns a list of pairs of DDRMSynthControl index and the value they should take to load a specific tone selector preset in one DDRM channel
+        SynthControlIdValuePairs idValuePairs = getSynthControlIdValuePairsForToneSelectorPreset(toneSelectorPresetName, ddrmChannel);
+        SynthControlIndexValuePairs indexValuePairs;
+        indexValuePairs.reserve(idValuePairs.size());
+        for (int i=0; i < idValuePairs.size(); i++){
+            int controlIndex = getControlIndexForID(idValuePairs[i].first);
+            if (controlIndex > -1){
+                indexValuePairs.emplace_back(controlIndex, idValuePairs[i].second);
+            }
+        }
+        return indexValuePairs;
     }
     
     // Function to return SynthControlIdValuePairs for tone selector presets
@@ -353,14 +356,13 @@ public:
         // as input data for the timbre space. Each row in the matrix corresponds to one preset, each
         // column to the normalized value of one parameter.
         timbreSpaceInputDataMatrix data;
-        std::vector<String> controlIDs = getDDRMSynthControlIDsForTimbreSpace();
+        std::array<double, DDRM_NUM_SYNTH_CONTROLS> normValues;
         for (int i=0; i < presetBank.getNumPresetsInBank(); i++){
             std::vector<float> presetValues;
-            DDRMPresetBytes& presetBytes = presetBank.getPresetBytesAtIndex(i);
-            for (int j=0; j < controlIDs.size(); j++){
-                DDRMSynthControl* synthControl = getDDRMSynthControlWithID(controlIDs[j]);
-                float value = (float)synthControl->getNormValueFromPresetByteArray(presetBytes);
-                presetValues.push_back(value);
+            presetValues.reserve(timbreSpaceControlIndexes.size());
+            DDRMPresetDecoder::getNormValues(presetBank.getPresetBytesAtIndex(i), normValues);
+            for (int j=0; j < timbreSpaceControlIndexes.size(); j++){
+                presetValues.push_back((float)normValues[timbreSpaceControlIndexes[j]]);
             }
             data.push_back(presetValues);
         }
@@ -396,22 +398,22 @@ public:
     
     void setToneSelectorComponentRow1ButtonsToNone()
     {
-        sendActionMessage(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1_OFF);
+        postEvent(DDRMEvent::setToneSelectorButtonsRow1Off);
     }
     
     void setToneSelectorComponentRow2ButtonsToNone()
     {
-        sendActionMessage(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2_OFF);
+        postEvent(DDRMEvent::setToneSelectorButtonsRow2Off);
     }
     
     void setToneSelectorComponentRow1()
     {
-        sendActionMessage(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1);
+        postEvent(DDRMEvent::setToneSelectorButtonsRow1);
     }
     
     void setToneSelectorComponentRow2()
     {
-        sendActionMessage(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2);
+        postEvent(DDRMEvent::setToneSelectorButtonsRow2);
     }
     
     bool hasPresetsDataLoaded()
@@ -466,34 +468,28 @@ public:
         }
     }
     
-    SynthControlIdValuePairs getSynthControlIdValuePairsForCopyingChannelFromToChannelTo(AudioProcessorValueTreeState* currentParameters, int channelFrom, int channelTo)
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsForCopyingChannelFromToChannelTo(int channelFrom, int channelTo)
     {
-        std::vector<String> controlIDsChannelFrom = getDDRMSynthControlIDsForChannel(channelFrom);
-        std::vector<String> controlIDsChannelTo = getDDRMSynthControlIDsForChannel(channelTo);
-        SynthControlIdValuePairs idValuePairs;
+        // Returns a list of pairs of DDRMSynthControl index and the value they should take to copy the current values
+        // of the controls of channelFrom to the equivalent controls of channelTo
+        const std::vector<int>& controlIndexesChannelFrom = getControlIndexesForChannel(channelFrom);
+        SynthControlIndexValuePairs indexValuePairs;
         
-        for (int i=0; i<controlIDsChannelFrom.size(); i++){
-            String channelFromControlID = controlIDsChannelFrom[i];
-            String genericChannelControlID = channelFromControlID.substring(0, channelFromControlID.length() - 2);
-            String channelToControlID = "";
-            for (int j=0; j<controlIDsChannelTo.size(); j++){
-                if (controlIDsChannelTo[j].startsWith(genericChannelControlID)){
-                    channelToControlID = controlIDsChannelTo[j];
-                    break;
-                }
-            }
-            if (channelToControlID != ""){
-                AudioParameterFloat* audioParameter = (AudioParameterFloat*)currentParameters->getParameter(channelFromControlID);
+        for (int i=0; i<controlIndexesChannelFrom.size(); i++){
+            int channelFromControlIndex = controlIndexesChannelFrom[i];
+            int channelToControlIndex = equivalentControlIndexesInOtherChannel[channelFromControlIndex];
+            if ((channelToControlIndex > -1) && (synthControls[channelToControlIndex].getChannelNumber() == channelTo)){
+                AudioParameterFloat* audioParameter = (AudioParameterFloat*)controlParameters[channelFromControlIndex];
                 double channelFromParameterValueNorm = (double)audioParameter->get() / 127.0;  // Needs normalized value to set
-                idValuePairs.emplace_back(channelToControlID, channelFromParameterValueNorm);
+                indexValuePairs.emplace_back(channelToControlIndex, channelFromParameterValueNorm);
             }
         }
-        return idValuePairs;
+        return indexValuePairs;
     }
     
-    SynthControlIdValuePairs getSynthControlIdValuePairsFromPatchFile(const String& filepath)
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsFromPatchFile(const String& filepath)
     {
-        // Reads from DDRM patch file and prepares SynthControlIdValuePairs to update the current preset
+        // Reads from DDRM patch file and prepares SynthControlIndexValuePairs to update the current preset
         // This function might throw errors if file has not correct format or other problems happen
         // Calls to this function should be prepared for that
 
@@ -512,12 +508,12 @@ public:
             presetBytes[i] = byte_int;
         }
         
-        return getSynthControlIdValuePairsForPresetBytesArray(presetBytes);
+        return getSynthControlIndexValuePairsForPresetBytesArray(presetBytes);
     }
     
-    SynthControlIdValuePairs getSynthControlIdValuePairsForChannelFromVoiceFile(const String& filepath, int channelTo)
+    SynthControlIndexValuePairs getSynthControlIndexValuePairsForChannelFromVoiceFile(const String& filepath, int channelTo)
     {
-        // Reads from DDRM voice file and prepares SynthControlIdValuePairs to update the current preset
+        // Reads from DDRM voice file and prepares SynthControlIndexValuePairs to update the current preset
         // This function might throw errors if file has not correct format or other problems happen
         // Calls to this function should be prepared for that
         
@@ -536,7 +532,7 @@ public:
             voiceBytes[i] = byte_int;
         }
         
-        return getSynthControlIdValuePairsForVoiceBytesArray(voiceBytes, channelTo);
+        return getSynthControlIndexValuePairsForVoiceBytesArray(voiceBytes, channelTo);
     }
     
     DDRMPresetBytes& getLoadedPresetBytesAtIndex(int index)
@@ -544,9 +540,83 @@ public:
         return presetBank.getPresetBytesAtIndex(index);
     }
     
+    const float* getCachedNormValuesForPresetAtIndex(int index)
+    {
+        // Decoded values of all synth controls for the preset at index (see DDRMPresetBank cache)
+        return presetBank.getCachedNormValuesAtIndex(index);
+    }
+    
+    const uint8* getCachedCCFramesForPresetAtIndex(int index)
+    {
+        // MIDI CC frames of all synth controls for the preset at index (see DDRMPresetBank cache)
+        return presetBank.getCachedCCFramesAtIndex(index);
+    }
+    
 private:
     
     std::vector<DDRMSynthControl> synthControls;
+    HashMap<String, int> controlIndexesByID;
+    std::vector<RangedAudioParameter*> controlParameters;
+    std::vector<int> allControlIndexes;
+    std::vector<int> channel1ControlIndexes;
+    std::vector<int> channel2ControlIndexes;
+    std::vector<int> otherChannelControlIndexes;
+    std::vector<int> timbreSpaceControlIndexes;
+    std::vector<int> equivalentControlIndexesInOtherChannel;  // For channel 1/2 controls, index of the same control in the other channel (-1 if none)
+    CCDispatchTable ccDispatchTable;
+    const CCDispatchEntry unassignedCCDispatchEntry = {nullptr, -1};
+    
+    void buildControlIndexTables (AudioProcessorValueTreeState* parameters)
+    {
+        // Builds the ID -> index map and the per-control parameter table, and copies the compile-time
+        // index lists (see DDRMSynthControlDescriptors.h) used in bulk operations
+        controlIndexesByID.clear();
+        controlParameters.clear();
+        allControlIndexes.clear();
+        for (int i=0; i < synthControls.size(); i++){
+            controlIndexesByID.set(synthControls[i].getID(), i);
+            controlParameters.push_back(parameters->getParameter(synthControls[i].getID()));
+            allControlIndexes.push_back(i);
+        }
+        channel1ControlIndexes.assign(ddrmChannel1ControlIndexes.indexes, ddrmChannel1ControlIndexes.indexes + ddrmChannel1ControlIndexes.numIndexes);
+        channel2ControlIndexes.assign(ddrmChannel2ControlIndexes.indexes, ddrmChannel2ControlIndexes.indexes + ddrmChannel2ControlIndexes.numIndexes);
+        otherChannelControlIndexes.assign(ddrmOtherChannelControlIndexes.indexes, ddrmOtherChannelControlIndexes.indexes + ddrmOtherChannelControlIndexes.numIndexes);
+        timbreSpaceControlIndexes.assign(ddrmTimbreSpaceControlIndexes.indexes, ddrmTimbreSpaceControlIndexes.indexes + ddrmTimbreSpaceControlIndexes.numIndexes);
+        
+        // Channel 1 and 2 control IDs only differ in the "_1"/"_2" suffix
+        equivalentControlIndexesInOtherChannel.assign(synthControls.size(), -1);
+        for (int i=0; i < synthControls.size(); i++){
+            int channel = synthControls[i].getChannelNumber();
+            if ((channel == 1) || (channel == 2)){
+                String controlID = synthControls[i].getID();
+                String equivalentControlID = controlID.substring(0, controlID.length() - 1) + String(channel == 1 ? 2 : 1);
+                equivalentControlIndexesInOtherChannel[i] = getControlIndexForID(equivalentControlID);
+            }
+        }
+    }
+    
+    std::vector<String> getDDRMSynthControlIDsForControlIndexes (const std::vector<int>& controlIndexes)
+    {
+        std::vector<String> synthControlIDS;
+        for (int i=0; i < controlIndexes.size(); i++){
+            synthControlIDS.push_back(synthControls[controlIndexes[i]].getID());
+        }
+        return synthControlIDS;
+    }
+    
+    void buildCCDispatchTable ()
+    {
+        // Pre-computes the CC number -> audio parameter table used to dispatch incoming MIDI CC messages
+        // CC number -> control index mapping is known at compile time (see DDRMSynthControlDescriptors.h)
+        for (int ccNumber=0; ccNumber < ccDispatchTable.size(); ccNumber++){
+            int controlIndex = ddrmCCNumberToControlIndex[ccNumber];
+            if (controlIndex > -1){
+                ccDispatchTable[ccNumber] = {controlParameters[controlIndex], controlIndex};
+            } else {
+                ccDispatchTable[ccNumber] = unassignedCCDispatchEntry;
+            }
+        }
+    }
     DDRMToneSelectorPresets ddrmToneSelectorPresets;
     String selectedToneSelectorRow1;
     String selectedToneSelectorRow2;
@@ -0,0 +1,158 @@
+//
+//  DDRMLevelChangeDetector.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+
+class DDRMLevelChangeDetector
+
+{
+public:
+    /*
+     DDRMLevelChangeDetector analyses the audio input bus of the plugin (which receives the DDRM audio
+     output during sound latency calibration, see DDRMSoundLatencyCalibrator). It follows the level of
+     the input with a peak envelope and can either:
+     - measure the average level over a period of time (startMeasuringLevel/getMeasuredLevel)
+     - detect the first sample at which the level rises above a threshold (arm/hasDetected) and
+       report its time in the high resolution milliseconds counter
+
+     processBlock is called from the audio thread and is real-time safe. When the detector is idle it
+     returns immediately. The time of each input sample is estimated assuming that processBlock is
+     called as soon as the block has been captured (the latency of the audio device driver is not
+     included).
+     */
+
+    DDRMLevelChangeDetector ()
+    {
+        mode = Mode::idle;
+        needsEnvelopeReset = true;
+        envelope = 0.0f;
+        envelopeDecay = 0.0f;
+        envelopeDecaySampleRate = 0.0;
+        measuredLevelSum = 0.0;
+        measuredNumSamples = 0;
+        detectionThreshold = 1.0f;
+        detectionTime = -1.0;
+    }
+
+    ~DDRMLevelChangeDetector ()
+    {
+    }
+
+    void startMeasuringLevel ()
+    {
+        mode = Mode::idle;
+        measuredLevelSum = 0.0;
+        measuredNumSamples = 0;
+        needsEnvelopeReset = true;
+        mode = Mode::measuring;
+    }
+
+    float getMeasuredLevel ()
+    {
+        // Average envelope level since startMeasuringLevel was called
+        int64 numSamples = measuredNumSamples;
+        if (numSamples == 0){
+            return 0.0f;
+        }
+        return (float)(measuredLevelSum / numSamples);
+    }
+
+    void arm (float threshold)
+    {
+        mode = Mode::idle;
+        detectionThreshold = threshold;
+        detectionTime = -1.0;
+        needsEnvelopeReset = true;
+        mode = Mode::armed;
+    }
+
+    bool hasDetected ()
+    {
+        return mode == Mode::detected;
+    }
+
+    double getDetectionTime ()
+    {
+        return detectionTime;
+    }
+
+    void stop ()
+    {
+        mode = Mode::idle;
+    }
+
+    void processBlock (const AudioBuffer<float>& buffer, int numInputChannels, double blockTime, double sampleRate)
+    {
+        // blockTime is the time at which processBlock was called (high resolution milliseconds counter)
+        Mode currentMode = mode;
+        if ((currentMode == Mode::idle) || (currentMode == Mode::detected) || (numInputChannels == 0) || (sampleRate <= 0.0)){
+            return;
+        }
+        if (sampleRate != envelopeDecaySampleRate){
+            envelopeDecay = (float)std::exp(-1.0 / (LEVEL_DETECTOR_ENVELOPE_DECAY_MS * 0.001 * sampleRate));
+            envelopeDecaySampleRate = sampleRate;
+        }
+        if (needsEnvelopeReset.exchange(false)){
+            // Envelope is not updated while idle, start each measurement/detection from silence
+            envelope = 0.0f;
+        }
+
+        int numSamples = buffer.getNumSamples();
+        int numChannels = jmin(numInputChannels, buffer.getNumChannels());
+        float threshold = detectionThreshold;
+        double levelSum = 0.0;
+        for (int i=0; i<numSamples; i++){
+            float peak = 0.0f;
+            for (int channel=0; channel<numChannels; channel++){
+                peak = jmax(peak, std::abs(buffer.getReadPointer(channel)[i]));
+            }
+            envelope = jmax(peak, envelope * envelopeDecay);
+            if (currentMode == Mode::measuring){
+                levelSum += envelope;
+            } else if (envelope >= threshold){
+                detectionTime = blockTime - 1000.0 * (numSamples - i) / sampleRate;
+                mode = Mode::detected;
+                return;
+            }
+        }
+        if (currentMode == Mode::measuring){
+            measuredLevelSum = measuredLevelSum + levelSum;
+            measuredNumSamples = measuredNumSamples + numSamples;
+        }
+    }
+
+private:
+
+    enum class Mode
+    {
+        idle = 0,
+        measuring,
+        armed,
+        detected
+    };
+
+    std::atomic<Mode> mode;
+    std::atomic<bool> needsEnvelopeReset;  // Set when starting to measure or arming, envelope is reset by the audio thread
+
+    // Only accessed by the audio thread
+    float envelope;
+    float envelopeDecay;
+    double envelopeDecaySampleRate;
+
+    std::atomic<double> measuredLevelSum;
+    std::atomic<int64> measuredNumSamples;
+    std::atomic<float> detectionThreshold;
+    std::atomic<double> detectionTime;
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMLevelChangeDetector)
+};
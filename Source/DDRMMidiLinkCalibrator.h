@@ -0,0 +1,174 @@
+//
+//  DDRMMidiLinkCalibrator.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "DDRMInterface.h"
+#include "DDRMMidiTransmitter.h"
+
+class DDRMMidiLinkCalibrator: public ThreadWithProgressWindow
+
+{
+public:
+    /*
+     DDRMMidiLinkCalibrator measures the capacity of the MIDI link to the DDRM using the fact that
+     the synth echoes every CC it receives. It needs both MIDI output and MIDI input connected to the
+     synth. To avoid changing the sound, calibration messages are sent to CC numbers which are not
+     assigned to any synth control.
+
+     Calibration has two steps:
+     1) Round trip time: probe messages are sent one at a time at a low rate and the time until their
+        echo comes back is measured. If no echo comes back, calibration fails.
+     2) Capacity: bursts of MIDI_LINK_CALIBRATION_BURST_SIZE messages are sent at increasing rates
+        (see calibrationRates). The highest rate for which all echoes come back (times
+        MIDI_LINK_CALIBRATION_SAFETY_FACTOR) is the calibrated link rate. Bursts are limited to the
+        number of echoes the expected echo tracker can hold for the calibration CC numbers
+        (MIDI_ECHO_SLOTS_PER_CC each), otherwise echoes would be overwritten before coming back.
+
+     Echo acknowledgement of the transmitter is disabled while calibrating so calibration messages
+     are never resent.
+     */
+
+    DDRMMidiLinkCalibrator (DDRMMidiTransmitter* t, DDRMInterface* i)
+        : ThreadWithProgressWindow ("Calibrating MIDI link...", true, true)
+    {
+        midiTransmitter = t;
+        ddrmInterface = i;
+        succeeded = false;
+        calibratedBytesPerSecond = MIDI_LINK_RATE_DIN;
+        measuredRoundTripMs = MIDI_ECHO_INITIAL_LATENCY_ESTIMATE_MS;
+
+        // Collect CC numbers not assigned to any synth control
+        const int candidateCCNumbers[] = {3, 14, 15, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31};
+        for (int ccNumber: candidateCCNumbers){
+            if (ddrmInterface->getCCDispatchEntry(ccNumber).parameter == nullptr){
+                calibrationCCNumbers.add(ccNumber);
+            }
+        }
+    }
+
+    ~DDRMMidiLinkCalibrator ()
+    {
+    }
+
+    void run () override
+    {
+        if (calibrationCCNumbers.size() == 0){
+            errorMessage = "No free MIDI CC numbers available for calibration.";
+            return;
+        }
+
+        bool wasEchoAcknowledgementEnabled = midiTransmitter->isEchoAcknowledgementEnabled();
+        float previousEchoLatencyMs = midiTransmitter->getEstimatedEchoLatencyMs();
+        midiTransmitter->setEchoAcknowledgementEnabled(false);
+
+        if (measureRoundTrip()){
+            measureCapacity();
+        }
+
+        if (!succeeded){
+            midiTransmitter->setEstimatedEchoLatencyMs(previousEchoLatencyMs);
+        }
+        midiTransmitter->setEchoAcknowledgementEnabled(wasEchoAcknowledgementEnabled);
+    }
+
+    bool succeeded;
+    int calibratedBytesPerSecond;
+    float measuredRoundTripMs;
+    String errorMessage;
+
+private:
+
+    DDRMMidiTransmitter* midiTransmitter;
+    DDRMInterface* ddrmInterface;
+    Array<int> calibrationCCNumbers;
+
+    bool waitForEchoes (int numConsumedEchoesTarget, double timeoutMs)
+    {
+        // Waits until the transmitter has consumed the given number of echoes. Returns false on timeout or cancel.
+        double startTime = Time::getMillisecondCounterHiRes();
+        while (midiTransmitter->getNumConsumedEchoes() < numConsumedEchoesTarget){
+            if (threadShouldExit() || (Time::getMillisecondCounterHiRes() - startTime > timeoutMs)){
+                return false;
+            }
+            Thread::sleep(1);
+        }
+        return true;
+    }
+
+    bool measureRoundTrip ()
+    {
+        setStatusMessage("Measuring round trip time...");
+        // Use the widest echo window while measuring so slow echoes are not taken as lost
+        midiTransmitter->setEstimatedEchoLatencyMs(MIDI_ECHO_WINDOW_MAX_MS / MIDI_ECHO_WINDOW_LATENCY_FACTOR);
+        double totalRoundTripMs = 0.0;
+        int numEchoes = 0;
+        for (int i=0; i<MIDI_LINK_CALIBRATION_NUM_PROBES; i++){
+            if (threadShouldExit()){
+                errorMessage = "Calibration cancelled.";
+                return false;
+            }
+            setProgress((double)i / (MIDI_LINK_CALIBRATION_NUM_PROBES + calibrationRates.size()));
+            int numConsumedEchoes = midiTransmitter->getNumConsumedEchoes();
+            double sendTime = Time::getMillisecondCounterHiRes();
+            midiTransmitter->sendCalibrationBurst(calibrationCCNumbers, 1, MIDI_LINK_CALIBRATION_PROBE_RATE);
+            if (waitForEchoes(numConsumedEchoes + 1, MIDI_LINK_CALIBRATION_ECHO_WAIT_MS)){
+                totalRoundTripMs += Time::getMillisecondCounterHiRes() - sendTime;
+                numEchoes++;
+            }
+            Thread::sleep(1000 * MIDI_CC_MESSAGE_NUM_BYTES / MIDI_LINK_CALIBRATION_PROBE_RATE);
+        }
+
+        if (numEchoes == 0){
+            errorMessage = "No MIDI messages came back from the DDRM. Make sure the DDRM MIDI output is connected to the selected MIDI input device.";
+            return false;
+        }
+        measuredRoundTripMs = (float)(totalRoundTripMs / numEchoes);
+        midiTransmitter->setEstimatedEchoLatencyMs(measuredRoundTripMs);
+        return true;
+    }
+
+    void measureCapacity ()
+    {
+        int bestBytesPerSecond = -1;
+        for (int i=0; i<calibrationRates.size(); i++){
+            if (threadShouldExit()){
+                errorMessage = "Calibration cancelled.";
+                return;
+            }
+            int bytesPerSecond = calibrationRates[i];
+            setStatusMessage("Testing " + String(bytesPerSecond) + " bytes per second...");
+            setProgress((double)(MIDI_LINK_CALIBRATION_NUM_PROBES + i) / (MIDI_LINK_CALIBRATION_NUM_PROBES + calibrationRates.size()));
+
+            int numConsumedEchoes = midiTransmitter->getNumConsumedEchoes();
+            int burstSize = jmin(MIDI_LINK_CALIBRATION_BURST_SIZE, calibrationCCNumbers.size() * MIDI_ECHO_SLOTS_PER_CC);
+            int numSent = midiTransmitter->sendCalibrationBurst(calibrationCCNumbers, burstSize, bytesPerSecond);
+            if (!waitForEchoes(numConsumedEchoes + numSent, MIDI_LINK_CALIBRATION_ECHO_WAIT_MS)){
+                break;  // Messages were lost at this rate (or calibration was cancelled)
+            }
+            bestBytesPerSecond = bytesPerSecond;
+        }
+
+        if (threadShouldExit()){
+            errorMessage = "Calibration cancelled.";
+            return;
+        }
+        if (bestBytesPerSecond < 0){
+            errorMessage = "Messages were lost even at the lowest calibration rate.";
+            return;
+        }
+        calibratedBytesPerSecond = (int)(bestBytesPerSecond * MIDI_LINK_CALIBRATION_SAFETY_FACTOR);
+        succeeded = true;
+    }
+
+    const Array<int> calibrationRates = {1000, 2000, MIDI_LINK_RATE_DIN, 4000, 6000, 8000, 12000, 16000, 24000, 32000};  // Bytes per second
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMMidiLinkCalibrator)
+};
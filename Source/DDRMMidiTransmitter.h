@@ -0,0 +1,796 @@
+//
+//  DDRMMidiTransmitter.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "DDRMRealtimeTripwire.h"
+#include "DDRMExpectedEchoTracker.h"
+
+class DDRMMidiTransmitter: public Thread,
+                           public ActionBroadcaster
+
+{
+public:
+    /*
+     DDRMMidiTransmitter owns the MidiOutput used to talk to the DDRM and sends all outgoing
+     MIDI CC messages from a dedicated thread. Producers (parameter changes coming from host
+     automation/audio thread, MIDI input thread or message thread) never call
+     MidiOutput::sendMessageNow, they only write the new value in a per-CC "pending value" slot
+     and return immediately.
+     
+     If a CC already has a pending value which has not been transmitted yet, the new value simply
+     replaces it (last value wins) and the old one is counted as coalesced. The first time a CC
+     becomes pending, its number is pushed into a bounded lock-free multi-producer/single-consumer
+     ring so that the transmitter thread sends CCs in the order in which they were first changed.
+     As there can only be one ring entry per pending CC, the ring never holds more than 128 items.
+     
+     The transmitter thread drains the ring through a token bucket pacer configured with the byte
+     rate of the link to the synth (see MIDI_LINK_RATE_* defines). This avoids sending more data
+     than the DIN link or the DDRM USB CC handler can absorb, which would make stale values pile
+     up in the hardware and the synth lag behind the UI.
+     
+     The transmitter also keeps a shadow model of the hardware state: the last value actually
+     transmitted (or received from the synth) for each CC number. Pending values equal to the
+     shadow value are not transmitted, so patch-level operations which set all controls at once only
+     send the CCs that changed after 0-127 quantisation. A forced send bypasses that check. The shadow
+     state is invalidated when the output device or channel changes as we can't know the state of
+     the new destination.
+     
+     As the DDRM echoes every CC it receives, the echoes can be used as acknowledgements. When echo
+     acknowledgement is enabled (the MIDI input is connected to the synth and the link has been
+     calibrated, see DDRMMidiLinkCalibrator), the transmitter periodically checks for sent CCs whose
+     echo never came back. These are resent (if that is still the latest value for that CC) up to
+     MIDI_ECHO_MAX_RESENDS times, and the pacer rate backs off and then progressively recovers up
+     to the configured link rate.
+     
+     Alternatively, CCs can be sent through the host instead of a MIDI output device (host output
+     mode). In that case the transmitter thread does not drain the queue; the processor calls
+     renderToMidiBuffer from processBlock and pending CCs are written in the block's MidiBuffer.
+     Following the approach of MidiMessageCollector, CCs are delayed by one block and their sample
+     offsets are computed from the time at which they became pending, so the timing of parameter
+     changes is preserved relative to the host timeline. Coalescing, shadow state and pacing
+     (expressed in samples) apply in the same way as with the MIDI output device.
+     
+     When sending to a MIDI output device, note, pitch bend and aftertouch messages received from the
+     host in processBlock are merged with the CCs so that everything reaches the synth through a single
+     port in time order. The processor pushes them with enqueueHostMessage into a single-producer
+     ring, timestamped with their position in the block. Host messages have priority over CCs: when one
+     is due, only the CCs which became pending before it and fit in the pacer budget are sent first
+     (so a patch change made just before a note arrives before the note), the rest of a CC burst is
+     sent after the note. Host messages consume pacer tokens but are never held back by the pacer. The
+     tokens they consume can take the pacer into debt, down to -MIDI_TRANSMITTER_PACER_MAX_BURST_BYTES,
+     so after a dense run of notes CCs wait at most one burst's worth of link time before being sent.
+     
+     Producers which are not real-time (message thread, timer threads) wake the transmitter thread
+     with notify() when they queue a CC. The audio thread never signals it, as that takes a lock, so
+     the thread polls the queues with a short timed wait while there is work pending, while echo
+     acknowledgement is enabled or while audio processing is active (host messages can be queued at
+     any time, see setAudioProcessingActive). Otherwise it blocks until notified.
+     */
+
+    DDRMMidiTransmitter (): Thread ("DDRMMidiTransmitter")
+    {
+        midiOutputChannel = 1;
+        linkRateBytesPerSecond = MIDI_LINK_RATE_DIN;
+        enqueuePosition = 0;
+        dequeuePosition = 0;
+        effectiveLinkRateBytesPerSecond = MIDI_LINK_RATE_DIN;
+        pacerTokens = MIDI_TRANSMITTER_PACER_MAX_BURST_BYTES;
+        pacerLastRefillTime = Time::getMillisecondCounterHiRes();
+        echoAcknowledgementEnabled = false;
+        lastLostMessagesCheckTime = pacerLastRefillTime;
+        calibrationValueCounter = 0;
+        hostOutputEnabled = false;
+        audioProcessingActive = false;
+        isConsumingQueue = false;
+        lastRenderTime = 0.0;
+        hostPacerEmptySample = 0.0;
+        hostMessagesWritePosition = 0;
+        hostMessagesReadPosition = 0;
+        for (uint32 i=0; i<queue.size(); i++){
+            queue[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        for (int i=0; i<pendingValues.size(); i++){
+            pendingValues[i] = -1;  // -1 = no pending value for that CC
+            pendingSinceTimes[i] = 0;
+            pendingForcedSends[i] = false;
+            pendingResendCounts[i] = 0;
+        }
+        invalidateShadowState();
+        resetStats();
+        startThread();
+    }
+
+    ~DDRMMidiTransmitter ()
+    {
+        stopThread(MIDI_TRANSMITTER_STOP_TIMEOUT_MS);
+
+        const ScopedLock sl (outputDeviceLock);
+        midiOutput.reset();
+
+        // De-register action listeners
+        removeAllActionListeners();
+    }
+
+    // Producer side (lock-free, can be called from any thread except the audio thread as it notifies the transmitter thread)
+
+    bool enqueueControlChange (int ccNumber, int ccValue, bool forceSend=false)
+    {
+        return enqueueControlChangeWithResendCount(ccNumber, ccValue, forceSend, 0);
+    }
+
+    bool enqueueControlChangeWithResendCount (int ccNumber, int ccValue, bool forceSend, int resendCount)
+    {
+        // Sets the value to be sent for the given MIDI CC number. If a value for that CC is already pending,
+        // it is replaced by the new one. Returns false if the message could not be queued (in that case
+        // the message is dropped and counted in numDroppedMessages).
+        // If forceSend is false, the message will not be transmitted if the value equals the last value
+        // transmitted for that CC (see shadow state).
+        if ((ccNumber < 0) || (ccNumber >= pendingValues.size())){
+            numDroppedMessages++;
+            return false;
+        }
+        
+        if (forceSend){
+            pendingForcedSends[ccNumber] = true;
+        }
+        pendingResendCounts[ccNumber] = resendCount;
+        
+        int previousValue = pendingValues[ccNumber].exchange(jlimit(0, 127, ccValue), std::memory_order_acq_rel);
+        if (previousValue > -1){
+            // CC number already in the queue, the transmitter thread will pick up the new value
+            numCoalescedMessages++;
+            return true;
+        }
+        
+        pendingSinceTimes[ccNumber] = Time::getMillisecondCounterHiRes();
+        if (!pushPendingCCNumber(ccNumber)){
+            pendingValues[ccNumber] = -1;
+            numDroppedMessages++;
+            return false;
+        }
+        DDRM_ASSERT_NOT_REALTIME  // Notifying takes a lock
+        notify();
+        return true;
+    }
+
+    void enqueueControlChangeFrames (const uint8* frames, int numFrames, bool forceSend=false)
+    {
+        // Queues a batch of pre-encoded 3-byte CC frames (status, CC number, value). The channel of the status
+        // byte is ignored, CCs are sent to the configured output channel.
+        for (int i=0; i<numFrames; i++){
+            const uint8* frame = frames + i * MIDI_CC_MESSAGE_NUM_BYTES;
+            enqueueControlChange(frame[1], frame[2], forceSend);
+        }
+    }
+
+    // MIDI output device configuration (message thread)
+
+    void setOutputDevice (const String& deviceIdentifier)
+    {
+        // Opens the MIDI output device with the given identifier. If identifier is "-", disables MIDI output
+        std::unique_ptr<MidiOutput> newMidiOutput;
+        if (deviceIdentifier != "-"){
+            newMidiOutput = MidiOutput::openDevice(deviceIdentifier);
+        }
+        DDRM_ASSERT_NOT_REALTIME  // Takes a lock
+        const ScopedLock sl (outputDeviceLock);
+        midiOutput.reset();
+        midiOutput = std::move(newMidiOutput);
+        invalidateShadowState();
+        notify();
+    }
+
+    bool hasOutputDevice ()
+    {
+        DDRM_ASSERT_NOT_REALTIME  // Takes a lock
+        const ScopedLock sl (outputDeviceLock);
+        return midiOutput.get() != nullptr;
+    }
+
+    bool hasDestination ()
+    {
+        // True if queued CCs reach the synth, either through the MIDI output device or through the host
+        return hostOutputEnabled || hasOutputDevice();
+    }
+
+    String getOutputDeviceName ()
+    {
+        DDRM_ASSERT_NOT_REALTIME  // Takes a lock
+        const ScopedLock sl (outputDeviceLock);
+        if (midiOutput.get() != nullptr){
+            return midiOutput.get()->getName();
+        }
+        return "-";
+    }
+
+    void setHostOutputEnabled (bool enabled)
+    {
+        // Enables host output mode (see renderToMidiBuffer). When enabled, the MIDI output device is closed
+        // as the host owns the MIDI ports.
+        if (enabled){
+            setOutputDevice("-");
+        }
+        if (hostOutputEnabled.exchange(enabled) != enabled){
+            invalidateShadowState();
+            notify();  // CCs pending when switching to the MIDI output device are sent by the transmitter thread
+        }
+    }
+    
+    void setAudioProcessingActive (bool active)
+    {
+        // To be called when the processor is prepared to play or releases its resources. While active, the
+        // transmitter thread polls the host messages queue as the audio thread does not notify it.
+        audioProcessingActive = active;
+        notify();
+    }
+    
+    bool isHostOutputEnabled ()
+    {
+        return hostOutputEnabled;
+    }
+    
+    void setOutputChannel (int channel)
+    {
+        if (midiOutputChannel.exchange(channel) != channel){
+            invalidateShadowState();
+        }
+    }
+    
+    void setLinkRate (int bytesPerSecond)
+    {
+        // Sets the maximum number of bytes per second that will be sent to the MIDI output device
+        // Use MIDI_LINK_RATE_UNLIMITED (0) to disable pacing
+        linkRateBytesPerSecond = jmax(0, bytesPerSecond);
+        effectiveLinkRateBytesPerSecond = linkRateBytesPerSecond.load();
+        notify();
+    }
+    
+    int getLinkRate ()
+    {
+        return linkRateBytesPerSecond;
+    }
+    
+    int getEffectiveLinkRate ()
+    {
+        // Rate currently used by the pacer (lower than the link rate after messages have been lost)
+        return (int)effectiveLinkRateBytesPerSecond;
+    }
+    
+    void setEchoAcknowledgementEnabled (bool enabled)
+    {
+        // Enables detection and resending of lost messages using the echoes of the synth
+        // Should only be enabled if the MIDI input receives the echoes of the synth connected to the output
+        if (enabled && !echoAcknowledgementEnabled){
+            expectedEchoTracker.clear();  // Don't report messages sent before enabling as lost
+        }
+        echoAcknowledgementEnabled = enabled;
+        notify();
+    }
+    
+    bool isEchoAcknowledgementEnabled ()
+    {
+        return echoAcknowledgementEnabled;
+    }
+    
+    // Link calibration (see DDRMMidiLinkCalibrator)
+    
+    int sendCalibrationBurst (const Array<int>& ccNumbers, int numMessages, int bytesPerSecond)
+    {
+        // Sends numMessages CC messages (cycling through the given CC numbers and values) directly to the output
+        // device at the given rate, bypassing the queue and the pacer, and records them as expected echoes.
+        // The calling thread sleeps between messages and sends the messages which are due each time it wakes up
+        // (so at high rates messages are sent in groups of about 1 ms). The output device lock is only held while
+        // sending each group. Returns the number of messages sent.
+        DDRM_ASSERT_NOT_REALTIME  // Takes a lock
+        if ((ccNumbers.size() == 0) || (bytesPerSecond <= 0)){
+            return 0;
+        }
+        double intervalMs = 1000.0 * MIDI_CC_MESSAGE_NUM_BYTES / bytesPerSecond;
+        double startTime = Time::getMillisecondCounterHiRes();
+        int numSent = 0;
+        while (numSent < numMessages){
+            int numDue = jmin(numMessages, 1 + (int)((Time::getMillisecondCounterHiRes() - startTime) / intervalMs));
+            {
+                const ScopedLock sl (outputDeviceLock);
+                if (midiOutput.get() == nullptr){
+                    break;
+                }
+                for (; numSent<numDue; numSent++){
+                    int ccNumber = ccNumbers[numSent % ccNumbers.size()];
+                    int ccValue = calibrationValueCounter;
+                    calibrationValueCounter = (calibrationValueCounter + 1) % 128;
+                    midiOutput.get()->sendMessageNow(MidiMessage::controllerEvent(midiOutputChannel, ccNumber, ccValue));
+                    expectedEchoTracker.addExpectedEcho(ccNumber, ccValue, Time::getMillisecondCounter());
+                }
+            }
+            if (numSent < numMessages){
+                double nextSendTime = startTime + numSent * intervalMs;
+                Thread::sleep(jmax(1, (int)(nextSendTime - Time::getMillisecondCounterHiRes())));
+            }
+        }
+        return numSent;
+    }
+
+    double sendControlChangeNow (int ccNumber, int ccValue)
+    {
+        // Sends a CC message directly to the output device, bypassing the queue and the pacer, and records it as
+        // an expected echo. Returns the time at which it was sent (high resolution milliseconds counter) or -1 if
+        // there is no output device.
+        DDRM_ASSERT_NOT_REALTIME  // Takes a lock
+        const ScopedLock sl (outputDeviceLock);
+        if (midiOutput.get() == nullptr){
+            return -1.0;
+        }
+        double sendTime = Time::getMillisecondCounterHiRes();
+        midiOutput.get()->sendMessageNow(MidiMessage::controllerEvent(midiOutputChannel, ccNumber, ccValue));
+        expectedEchoTracker.addExpectedEcho(ccNumber, ccValue, Time::getMillisecondCounter());
+        lastTransmittedValues[ccNumber] = ccValue;
+        return sendTime;
+    }
+
+    // Shadow hardware state (can be called from any thread)
+    
+    void invalidateShadowState ()
+    {
+        // Marks the state of all CCs in the synth as unknown so next values will be transmitted
+        for (int i=0; i<lastTransmittedValues.size(); i++){
+            lastTransmittedValues[i] = -1;
+        }
+    }
+    
+    void updateShadowValueFromSynth (int ccNumber, int ccValue)
+    {
+        // To be called when a CC message that originated in the synth (e.g. a knob was moved) is received
+        if ((ccNumber >= 0) && (ccNumber < lastTransmittedValues.size())){
+            lastTransmittedValues[ccNumber] = ccValue;
+        }
+    }
+    
+    int getShadowValue (int ccNumber)
+    {
+        // Returns the last value transmitted to the synth for the given CC number (-1 if unknown)
+        if ((ccNumber < 0) || (ccNumber >= lastTransmittedValues.size())){
+            return -1;
+        }
+        return lastTransmittedValues[ccNumber];
+    }
+
+    // Stats and bookkeeping (can be called from any thread)
+
+    bool consumeExpectedEcho (int ccNumber, int ccValue)
+    {
+        // To be called from the MIDI input thread for every CC received from the synth. Returns true if
+        // the message is the echo of a message sent by the transmitter (see DDRMExpectedEchoTracker)
+        return expectedEchoTracker.consumeExpectedEcho(ccNumber, ccValue, Time::getMillisecondCounter());
+    }
+    
+    float getEstimatedEchoLatencyMs ()
+    {
+        return expectedEchoTracker.getEstimatedEchoLatencyMs();
+    }
+    
+    void setEstimatedEchoLatencyMs (float latencyMs)
+    {
+        // Sets the round trip latency estimate (e.g. measured by link calibration), which determines the echo window
+        expectedEchoTracker.setEstimatedEchoLatencyMs(latencyMs);
+    }
+    
+    int getNumConsumedEchoes ()
+    {
+        return expectedEchoTracker.getNumConsumedEchoes();
+    }
+    
+    int getNumLostMessages ()
+    {
+        // Number of sent messages whose echo never came back (only counted if echo acknowledgement is enabled)
+        return numLostMessages;
+    }
+    
+    int getNumResentMessages ()
+    {
+        return numResentMessages;
+    }
+
+    int getNumDroppedMessages ()
+    {
+        return numDroppedMessages;
+    }
+    
+    int getNumCoalescedMessages ()
+    {
+        // Number of CC values that were replaced by a newer value for the same CC before being sent
+        return numCoalescedMessages;
+    }
+    
+    int getNumSentMessages ()
+    {
+        return numSentMessages;
+    }
+    
+    int getNumUnchangedMessages ()
+    {
+        // Number of CC values not transmitted because they were equal to the shadow state
+        return numUnchangedMessages;
+    }
+    
+    int64 getMaxQueueLatencyMs ()
+    {
+        // Maximum time (in milliseconds) that a CC has been pending before being sent (worst case latency)
+        return maxQueueLatencyMs;
+    }
+    
+    void resetStats ()
+    {
+        numDroppedMessages = 0;
+        numCoalescedMessages = 0;
+        numSentMessages = 0;
+        numUnchangedMessages = 0;
+        maxQueueLatencyMs = 0;
+        numLostMessages = 0;
+        numResentMessages = 0;
+        expectedEchoTracker.resetStats();
+    }
+
+    // Host MIDI merge (audio thread)
+    
+    static bool isMergeableHostMessage (const MidiMessage& message)
+    {
+        // Host messages which are merged with the CCs sent to the synth
+        return message.isNoteOnOrOff() || message.isPitchWheel() || message.isChannelPressure() || message.isAftertouch();
+    }
+    
+    bool enqueueHostMessage (const MidiMessage& message, double sendTime)
+    {
+        // Queues a note/pitch bend/aftertouch message from the host to be sent at the given time (hi-res ms counter)
+        // Should only be called from the audio thread (single producer). Returns false if the queue is full.
+        uint32 writePosition = hostMessagesWritePosition.load(std::memory_order_relaxed);
+        if (writePosition - hostMessagesReadPosition.load(std::memory_order_acquire) >= MIDI_TRANSMITTER_HOST_QUEUE_SIZE){
+            numDroppedMessages++;
+            return false;
+        }
+        QueuedHostMessage& slot = hostMessages[writePosition & (MIDI_TRANSMITTER_HOST_QUEUE_SIZE - 1)];
+        slot.numBytes = jmin(3, message.getRawDataSize());
+        for (int i=0; i<slot.numBytes; i++){
+            slot.data[i] = message.getRawData()[i];
+        }
+        slot.sendTime = sendTime;
+        hostMessagesWritePosition.store(writePosition + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer side (transmitter thread, or audio thread in host output mode)
+
+    void renderToMidiBuffer (MidiBuffer& midiMessages, int numSamples, double sampleRate)
+    {
+        // Writes pending CCs into the host MIDI buffer with sample offsets. Called from processBlock.
+        double now = Time::getMillisecondCounterHiRes();
+        double previousRenderTime = lastRenderTime;
+        lastRenderTime = now;
+        if ((!hostOutputEnabled) || (numSamples <= 0) || (sampleRate <= 0.0) || isConsumingQueue.exchange(true)){
+            return;
+        }
+        
+        // CCs which became pending during the previous block are rendered in this block at the same relative
+        // position. If the host has not called processBlock for a while (e.g. after being stopped), only the
+        // last block duration is mapped.
+        double blockDurationMs = 1000.0 * numSamples / sampleRate;
+        if (now - previousRenderTime > 2 * blockDurationMs){
+            previousRenderTime = now - blockDurationMs;
+        }
+        
+        refillPacerTokens();  // Updates effective link rate
+        hostMessagesReadPosition.store(hostMessagesWritePosition.load(std::memory_order_acquire), std::memory_order_release);  // Host messages queued before switching to host output are stale
+        bool pacingEnabled = linkRateBytesPerSecond != MIDI_LINK_RATE_UNLIMITED;
+        double samplesPerMessage = 0.0;
+        double maxBurstSamples = 0.0;
+        if (pacingEnabled){
+            samplesPerMessage = MIDI_CC_MESSAGE_NUM_BYTES * sampleRate / effectiveLinkRateBytesPerSecond;
+            maxBurstSamples = MIDI_TRANSMITTER_PACER_MAX_BURST_BYTES * sampleRate / effectiveLinkRateBytesPerSecond;
+        }
+        
+        while (peekPendingCCNumber()){
+            int ccNumber = getPeekedCCNumber();
+            int sampleOffset = jlimit(0, numSamples - 1, (int)((pendingSinceTimes[ccNumber] - previousRenderTime) * sampleRate / 1000.0));
+            if (pacingEnabled){
+                // Token bucket in samples: hostPacerEmptySample is the position at which the bucket is empty
+                sampleOffset = jmax(sampleOffset, (int)std::ceil(hostPacerEmptySample + samplesPerMessage));
+                if (sampleOffset >= numSamples){
+                    break;  // Not enough bandwidth left in this block, keep remaining CCs pending
+                }
+            }
+            
+            popPendingCCNumber();
+            int ccValue, resendCount;
+            if (!takePendingValue(ccNumber, ccValue, resendCount)){
+                continue;
+            }
+            midiMessages.addEvent(MidiMessage::controllerEvent(midiOutputChannel, ccNumber, ccValue), sampleOffset);
+            if (pacingEnabled){
+                hostPacerEmptySample = jmax(hostPacerEmptySample, sampleOffset - maxBurstSamples) + samplesPerMessage;
+            }
+            recordTransmittedValue(ccNumber, ccValue, resendCount);
+        }
+        hostPacerEmptySample = jmax(hostPacerEmptySample - numSamples, -maxBurstSamples);
+        isConsumingQueue = false;
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit()){
+            bool hasPendingMessages = drainQueue();
+            if (echoAcknowledgementEnabled){
+                checkLostMessages();
+            }
+            // A notify() received since the last wait makes the next wait return immediately, so no CC is missed
+            bool mustPoll = hasPendingMessages || echoAcknowledgementEnabled || (audioProcessingActive && !hostOutputEnabled);
+            wait(mustPoll ? MIDI_TRANSMITTER_POLL_WAIT_MS : -1);
+        }
+    }
+
+private:
+
+    struct QueuedCCNumber {
+        std::atomic<uint32> sequence;
+        int ccNumber;
+    };
+
+    std::array<QueuedCCNumber, MIDI_TRANSMITTER_QUEUE_SIZE> queue;
+    std::atomic<uint32> enqueuePosition;
+    uint32 dequeuePosition;  // Only accessed by the consumer (see isConsumingQueue)
+    std::atomic<bool> isConsumingQueue;  // Ensures only one thread consumes the queue when switching output mode
+    
+    std::array<std::atomic<int>, 128> pendingValues;  // Last value set for each CC number which has not been sent yet (-1 if none)
+    std::array<std::atomic<double>, 128> pendingSinceTimes;  // Time at which each CC number became pending (hi-res ms counter)
+    std::array<std::atomic<bool>, 128> pendingForcedSends;  // Whether pending CC should be sent even if equal to shadow value
+    std::array<std::atomic<int>, 128> pendingResendCounts;  // Number of times the pending value has already been resent
+    std::array<std::atomic<int>, 128> lastTransmittedValues;  // Shadow hardware state (-1 if unknown)
+    
+    std::atomic<int> linkRateBytesPerSecond;
+    std::atomic<double> effectiveLinkRateBytesPerSecond;  // Link rate after backing off because of lost messages
+    double pacerTokens;  // Only accessed by transmitter thread
+    double pacerLastRefillTime;  // Only accessed by transmitter thread
+
+    CriticalSection outputDeviceLock;  // Never taken by producers, only by transmitter thread and device configuration
+    std::unique_ptr<MidiOutput> midiOutput;
+    std::atomic<int> midiOutputChannel;  // Range 1-16
+    int calibrationValueCounter;  // Only accessed with outputDeviceLock held
+    
+    struct QueuedHostMessage {
+        uint8 data[3];
+        int numBytes;
+        double sendTime;  // Hi-res ms counter
+    };
+    
+    std::array<QueuedHostMessage, MIDI_TRANSMITTER_HOST_QUEUE_SIZE> hostMessages;
+    std::atomic<uint32> hostMessagesWritePosition;  // Only written by audio thread
+    std::atomic<uint32> hostMessagesReadPosition;  // Only written by the consumer
+    
+    std::atomic<bool> hostOutputEnabled;
+    std::atomic<bool> audioProcessingActive;  // Processor is prepared to play (host messages can be queued)
+    double lastRenderTime;  // Only accessed by audio thread
+    double hostPacerEmptySample;  // Only accessed by the consumer
+    
+    std::atomic<bool> echoAcknowledgementEnabled;
+    double lastLostMessagesCheckTime;  // Only accessed by transmitter thread
+
+    DDRMExpectedEchoTracker expectedEchoTracker;
+    std::atomic<int> numDroppedMessages;
+    std::atomic<int> numCoalescedMessages;
+    std::atomic<int> numSentMessages;
+    std::atomic<int> numUnchangedMessages;
+    std::atomic<int64> maxQueueLatencyMs;
+    std::atomic<int> numLostMessages;
+    std::atomic<int> numResentMessages;
+    
+    bool pushPendingCCNumber (int ccNumber)
+    {
+        uint32 position = enqueuePosition.load(std::memory_order_relaxed);
+        QueuedCCNumber* cell;
+        for (;;){
+            cell = &queue[position & (MIDI_TRANSMITTER_QUEUE_SIZE - 1)];
+            uint32 sequence = cell->sequence.load(std::memory_order_acquire);
+            int32 diff = (int32)sequence - (int32)position;
+            if (diff == 0){
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            } else if (diff < 0){
+                return false;  // Queue is full
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->ccNumber = ccNumber;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool peekPendingCCNumber ()
+    {
+        QueuedCCNumber& cell = queue[dequeuePosition & (MIDI_TRANSMITTER_QUEUE_SIZE - 1)];
+        uint32 sequence = cell.sequence.load(std::memory_order_acquire);
+        return (int32)sequence - (int32)(dequeuePosition + 1) >= 0;
+    }
+    
+    int getPeekedCCNumber ()
+    {
+        // Should only be called after peekPendingCCNumber returned true
+        return queue[dequeuePosition & (MIDI_TRANSMITTER_QUEUE_SIZE - 1)].ccNumber;
+    }
+    
+    int popPendingCCNumber ()
+    {
+        // Should only be called after peekPendingCCNumber returned true
+        QueuedCCNumber& cell = queue[dequeuePosition & (MIDI_TRANSMITTER_QUEUE_SIZE - 1)];
+        int ccNumber = cell.ccNumber;
+        cell.sequence.store(dequeuePosition + MIDI_TRANSMITTER_QUEUE_SIZE, std::memory_order_release);
+        dequeuePosition++;
+        return ccNumber;
+    }
+    
+    void refillPacerTokens ()
+    {
+        double now = Time::getMillisecondCounterHiRes();
+        double elapsedMs = now - pacerLastRefillTime;
+        pacerLastRefillTime = now;
+        
+        // After backing off because of lost messages, the rate recovers progressively up to the configured link rate
+        double linkRate = linkRateBytesPerSecond;
+        double rate = jmin(linkRate, effectiveLinkRateBytesPerSecond + linkRate * MIDI_LINK_RATE_RECOVERY_PER_SECOND * elapsedMs / 1000.0);
+        effectiveLinkRateBytesPerSecond = rate;
+        pacerTokens = jmin((double)MIDI_TRANSMITTER_PACER_MAX_BURST_BYTES, pacerTokens + elapsedMs * rate / 1000.0);
+    }
+    
+    void checkLostMessages ()
+    {
+        // Resends the messages whose echo never came back (if they still hold the latest value for their CC)
+        double now = Time::getMillisecondCounterHiRes();
+        if (now - lastLostMessagesCheckTime < MIDI_ECHO_LOST_CHECK_INTERVAL_MS){
+            return;
+        }
+        lastLostMessagesCheckTime = now;
+        
+        int numLostEchoes = expectedEchoTracker.collectLostEchoes(Time::getMillisecondCounter(), [this] (int ccNumber, int ccValue, int resendCount)
+        {
+            numLostMessages++;
+            bool isLatestValue = (lastTransmittedValues[ccNumber] == ccValue) && (pendingValues[ccNumber] == -1);
+            if (isLatestValue && (resendCount < MIDI_ECHO_MAX_RESENDS)){
+                if (enqueueControlChangeWithResendCount(ccNumber, ccValue, true, resendCount + 1)){
+                    numResentMessages++;
+                }
+            }
+        });
+        
+        if ((numLostEchoes > 0) && (linkRateBytesPerSecond != MIDI_LINK_RATE_UNLIMITED)){
+            // The link is losing messages, back off the pacer rate
+            effectiveLinkRateBytesPerSecond = jmax((double)MIDI_LINK_RATE_MIN, effectiveLinkRateBytesPerSecond * MIDI_LINK_RATE_LOSS_BACKOFF);
+        }
+    }
+
+    bool takePendingValue (int ccNumber, int& ccValue, int& resendCount)
+    {
+        // Takes the pending value of a CC which has just been popped from the queue. Returns false if it should not
+        // be transmitted.
+        ccValue = pendingValues[ccNumber].exchange(-1, std::memory_order_acq_rel);
+        bool forceSend = pendingForcedSends[ccNumber].exchange(false);
+        resendCount = pendingResendCounts[ccNumber].exchange(0);
+        if (ccValue < 0){
+            return false;
+        }
+        if ((!forceSend) && (lastTransmittedValues[ccNumber] == ccValue)){
+            numUnchangedMessages++;
+            return false;  // Synth already has that value, no need to send it again
+        }
+        return true;
+    }
+    
+    void recordTransmittedValue (int ccNumber, int ccValue, int resendCount)
+    {
+        // Updates shadow state, expected echoes and stats after a CC has been transmitted
+        expectedEchoTracker.addExpectedEcho(ccNumber, ccValue, Time::getMillisecondCounter(), resendCount);  // The synth will send it back
+        lastTransmittedValues[ccNumber] = ccValue;
+        numSentMessages++;
+        int64 queueLatency = (int64)(Time::getMillisecondCounterHiRes() - pendingSinceTimes[ccNumber]);
+        if (queueLatency > maxQueueLatencyMs){
+            maxQueueLatencyMs = queueLatency;
+        }
+    }
+
+    void sendPendingCCs (double pendingSinceTimeLimit)
+    {
+        // Sends the pending CCs allowed by the pacer which became pending before the given time
+        // Should be called with outputDeviceLock held
+        while (peekPendingCCNumber()){
+            if (pendingSinceTimes[getPeekedCCNumber()] > pendingSinceTimeLimit){
+                break;
+            }
+            bool pacingEnabled = linkRateBytesPerSecond != MIDI_LINK_RATE_UNLIMITED;
+            if ((midiOutput.get() != nullptr) && pacingEnabled && (pacerTokens < MIDI_CC_MESSAGE_NUM_BYTES)){
+                break;  // Not enough bandwidth available now, keep remaining CCs pending
+            }
+            
+            int ccNumber = popPendingCCNumber();
+            int ccValue, resendCount;
+            if (!takePendingValue(ccNumber, ccValue, resendCount) || (midiOutput.get() == nullptr)){
+                continue;  // Nothing to send or no device configured, discard message
+            }
+            
+            MidiMessage msg = MidiMessage::controllerEvent(midiOutputChannel, ccNumber, ccValue);
+            midiOutput.get()->sendMessageNow(msg);
+            if (pacingEnabled){
+                pacerTokens -= MIDI_CC_MESSAGE_NUM_BYTES;
+            }
+            recordTransmittedValue(ccNumber, ccValue, resendCount);
+            
+            #if JUCE_DEBUG
+                if (LOG_INDIVIDUAL_PARAMETER_CHANGES == 1){
+                    logMessage(String::formatted("Sent MIDI CC: %i %i", ccNumber, ccValue));  // Not in host output mode (audio thread)
+                }
+            #endif
+        }
+    }
+    
+    void sendDueHostMessages ()
+    {
+        // Sends the host messages whose time has come, each preceded by the CCs which became pending before it
+        // Should be called with outputDeviceLock held
+        double now = Time::getMillisecondCounterHiRes();
+        uint32 readPosition = hostMessagesReadPosition.load(std::memory_order_relaxed);
+        while (readPosition != hostMessagesWritePosition.load(std::memory_order_acquire)){
+            const QueuedHostMessage& hostMessage = hostMessages[readPosition & (MIDI_TRANSMITTER_HOST_QUEUE_SIZE - 1)];
+            if (hostMessage.sendTime > now){
+                break;  // Messages are queued in time order
+            }
+            sendPendingCCs(hostMessage.sendTime);
+            if (midiOutput.get() != nullptr){
+                // Send in the channel of the synth, whatever the channel used in the host
+                MidiMessage msg (hostMessage.data, hostMessage.numBytes);
+                msg.setChannel(midiOutputChannel);
+                midiOutput.get()->sendMessageNow(msg);
+                if (linkRateBytesPerSecond != MIDI_LINK_RATE_UNLIMITED){
+                    // Can go negative so CCs wait for the link to catch up, but the debt is capped to one burst
+                    pacerTokens = jmax(-(double)MIDI_TRANSMITTER_PACER_MAX_BURST_BYTES, pacerTokens - hostMessage.numBytes);
+                }
+            }
+            readPosition++;
+            hostMessagesReadPosition.store(readPosition, std::memory_order_release);
+        }
+    }
+
+    bool drainQueue ()
+    {
+        // Returns true if CCs or host messages are still pending (e.g. held back by the pacer or not due yet)
+        if (hostOutputEnabled || isConsumingQueue.exchange(true)){
+            return false;  // Queue is consumed by the audio thread in host output mode
+        }
+        refillPacerTokens();
+        
+        {
+            const ScopedLock sl (outputDeviceLock);
+            sendDueHostMessages();
+            sendPendingCCs(Time::getMillisecondCounterHiRes());
+        }
+        bool hasPendingMessages = peekPendingCCNumber()
+            || (hostMessagesReadPosition.load(std::memory_order_relaxed) != hostMessagesWritePosition.load(std::memory_order_acquire));
+        isConsumingQueue = false;
+        return hasPendingMessages;
+    }
+
+    void logMessage (const String& message)
+    {
+        // Broadcasts a "LOG:" action with a message that will be received in the processor and logged
+        sendActionMessage(ACTION_LOG_PREFIX + message);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DDRMMidiTransmitter)
+};
@@ -0,0 +1,338 @@
+//
+//  DDRMMorphEngine.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "DDRMSynthControlDescriptors.h"
+#include "DDRMMidiTransmitter.h"
+
+enum class DDRMMorphCurve
+{
+    linear = 0,
+    easeInOut
+};
+
+class DDRMMorphEngine: private HighResolutionTimer,
+                       private AsyncUpdater
+
+{
+public:
+    /*
+     DDRMMorphEngine glides the synth from its current control values to a target (a bank preset, an
+     interpolated timbre space preset...) over a number of beats.
+
+     When a morph starts, the full CC trajectory of every control is precomputed: for each control,
+     one event is created for each quantised (0-127) value between source and target, at the morph
+     position (0-1) where the curve crosses that value. Controls which don't change have no events, and
+     no two consecutive events of a control have the same value. Events are sorted by position, so
+     playing the morph out is just walking the event list.
+
+     Events are played from the high resolution timer thread and queued in the MIDI transmitter. The
+     morph position is either the elapsed time (using the last known host tempo) or, if the host
+     transport was playing when the morph started, the host song position reported by processBlock
+     with setHostTransport (the morph holds while the transport is stopped). Each event is scheduled
+     lookaheadMs earlier than its position so the change of sound happens on time (see
+     DDRMSoundLatencyCalibrator). Events which would be scheduled before the morph start are clamped
+     to the start, and only the last of them is kept for each control (the others would be
+     overwritten before being heard).
+
+     The audio parameters are not changed while the morph plays. When it finishes, onMorphFinished is
+     called in the message thread so the owner can set the target values to the parameters. Controls
+     changed by other means during the morph must be released with releaseControl: their remaining
+     events are skipped and they are not part of the final values.
+     */
+
+    DDRMMorphEngine (DDRMMidiTransmitter* t)
+    {
+        midiTransmitter = t;
+        morphing = false;
+        hostIsPlaying = false;
+        hostPpqPosition = 0.0;
+        hostBpm = MORPH_DEFAULT_BPM;
+        lookaheadMs = 0.0f;
+        events.reserve(DDRM_NUM_SYNTH_CONTROLS * 128);
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            targetNormValues[i] = -1.0f;
+            releasedControls[i] = true;
+        }
+    }
+
+    ~DDRMMorphEngine ()
+    {
+        stopTimer();
+        cancelPendingUpdate();
+    }
+
+    std::function<void()> onMorphFinished;
+
+    void startMorph (const float* sourceNormValues, const SynthControlIndexValuePairs& target, double durationBeats, DDRMMorphCurve curve)
+    {
+        // Precomputes the CC trajectories from the source values (DDRM_NUM_SYNTH_CONTROLS values) to the target
+        // values and starts playing them (message thread)
+        stopMorph();
+
+        events.clear();
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            targetNormValues[i] = -1.0f;  // -1 = control not part of the morph
+            releasedControls[i] = false;
+        }
+        for (int i=0; i<target.size(); i++){
+            int controlIndex = target[i].first;
+            targetNormValues[controlIndex] = (float)target[i].second;
+            addControlTrajectory(controlIndex, sourceNormValues[controlIndex], (float)target[i].second, curve);
+        }
+        std::stable_sort(events.begin(), events.end(), [](const MorphEvent& a, const MorphEvent& b){
+            return a.position < b.position;
+        });
+
+        isSyncedToHost = hostIsPlaying;
+        morphDurationBeats = jmax(0.0, durationBeats);
+        morphDurationMs = morphDurationBeats * 60000.0 / jmax(1.0, (double)hostBpm);
+        scheduleEventsWithLookahead();
+
+        nextEventIndex = 0;
+        morphStartPpqPosition = -1.0;  // Set at the first tick
+        morphStartTime = Time::getMillisecondCounterHiRes();
+        morphing = true;
+        startTimer(MORPH_TIMER_INTERVAL_MS);
+    }
+
+    void stopMorph ()
+    {
+        // Stops the current morph (if any) without calling onMorphFinished
+        morphing = false;
+        stopTimer();
+        cancelPendingUpdate();
+    }
+
+    bool isMorphing ()
+    {
+        return morphing;
+    }
+
+    int getNumTrajectoryEvents ()
+    {
+        return (int)events.size();
+    }
+
+    void releaseControl (int controlIndex)
+    {
+        // To be called when a control is changed by other means while morphing (real-time safe)
+        if ((controlIndex >= 0) && (controlIndex < DDRM_NUM_SYNTH_CONTROLS)){
+            releasedControls[controlIndex] = true;
+        }
+    }
+
+    bool isControlMorphed (int controlIndex)
+    {
+        // True if the control was part of the last morph and was not released
+        return (targetNormValues[controlIndex] >= 0.0f) && !releasedControls[controlIndex];
+    }
+
+    bool hasReleasedControls ()
+    {
+        // True if any control was changed by other means during the last morph
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            if (releasedControls[i]){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    float getTargetNormValue (int controlIndex)
+    {
+        return targetNormValues[controlIndex];
+    }
+
+    void setLookaheadMs (float ms)
+    {
+        // Events are played this amount of time before their position (measured MIDI to sound latency)
+        lookaheadMs = jmax(0.0f, ms);
+    }
+
+    float getLookaheadMs ()
+    {
+        return lookaheadMs;
+    }
+
+    void setHostTransport (bool isPlaying, double ppqPosition, double bpm)
+    {
+        // Called from processBlock with the host playhead position (real-time safe)
+        hostPpqPosition = ppqPosition;
+        if (bpm > 0.0){
+            hostBpm = bpm;
+        }
+        hostIsPlaying = isPlaying;
+    }
+
+private:
+
+    struct MorphEvent
+    {
+        float position;  // 0-1, time at which the event is played (lookahead already subtracted)
+        int controlIndex;
+        int ccValue;
+    };
+
+    DDRMMidiTransmitter* midiTransmitter;
+    std::vector<MorphEvent> events;  // Only modified while the timer is stopped
+    int nextEventIndex;
+    std::array<float, DDRM_NUM_SYNTH_CONTROLS> targetNormValues;
+    std::array<std::atomic<bool>, DDRM_NUM_SYNTH_CONTROLS> releasedControls;
+    std::atomic<bool> morphing;
+
+    bool isSyncedToHost;
+    double morphDurationBeats;
+    double morphDurationMs;
+    double morphStartPpqPosition;
+    double morphStartTime;
+    std::atomic<bool> hostIsPlaying;
+    std::atomic<double> hostPpqPosition;
+    std::atomic<double> hostBpm;
+    std::atomic<float> lookaheadMs;
+
+    static float getCurveValue (DDRMMorphCurve curve, float t)
+    {
+        if (curve == DDRMMorphCurve::easeInOut){
+            return t * t * (3.0f - 2.0f * t);
+        }
+        return t;
+    }
+
+    static float getCurvePosition (DDRMMorphCurve curve, float y)
+    {
+        // Inverse of the curve (curves are monotonic, so bisection converges to the position where curve = y)
+        float low = 0.0f;
+        float high = 1.0f;
+        for (int i=0; i<MORPH_CURVE_INVERSION_ITERATIONS; i++){
+            float middle = 0.5f * (low + high);
+            if (getCurveValue(curve, middle) < y){
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        return high;
+    }
+
+    void addControlTrajectory (int controlIndex, float sourceNormValue, float targetNormValue, DDRMMorphCurve curve)
+    {
+        // Adds one event per quantised value crossed when going from source to target
+        float source = jlimit(0.0f, 1.0f, sourceNormValue) * 127.0f;
+        float target = jlimit(0.0f, 1.0f, targetNormValue) * 127.0f;
+        int sourceCCValue = roundToInt(source);
+        int targetCCValue = roundToInt(target);
+        if (sourceCCValue == targetCCValue){
+            return;
+        }
+        int direction = (targetCCValue > sourceCCValue) ? 1 : -1;
+        for (int ccValue=sourceCCValue + direction; ccValue!=targetCCValue + direction; ccValue+=direction){
+            // The quantised value becomes ccValue when the continuous value crosses ccValue -/+ 0.5
+            float threshold = (float)ccValue - 0.5f * direction;
+            float fraction = jlimit(0.0f, 1.0f, (threshold - source) / (target - source));
+            events.push_back({getCurvePosition(curve, fraction), controlIndex, ccValue});
+        }
+    }
+
+    void scheduleEventsWithLookahead ()
+    {
+        // Moves each event lookaheadMs earlier (events must be sorted by position). Events which end up
+        // before the morph start are clamped to it, keeping only the last one of each control.
+        if (morphDurationMs <= 0.0){
+            return;
+        }
+        float lookaheadPosition = (float)(lookaheadMs / morphDurationMs);
+        std::array<int, DDRM_NUM_SYNTH_CONTROLS> lastClampedEventIndex;
+        lastClampedEventIndex.fill(-1);
+        for (int i=0; i<events.size(); i++){
+            if (events[i].position - lookaheadPosition <= 0.0f){
+                lastClampedEventIndex[events[i].controlIndex] = i;
+            }
+        }
+        int numKeptEvents = 0;
+        for (int i=0; i<events.size(); i++){
+            MorphEvent event = events[i];
+            event.position -= lookaheadPosition;
+            if (event.position <= 0.0f){
+                if (lastClampedEventIndex[event.controlIndex] != i){
+                    continue;
+                }
+                event.position = 0.0f;
+            }
+            events[numKeptEvents++] = event;  // Order is preserved as all positions are shifted by the same amount
+        }
+        events.resize(numKeptEvents);
+    }
+
+    double getMorphPosition ()
+    {
+        // Returns the current morph position (0-1) or -1 if the morph is on hold
+        if (isSyncedToHost){
+            if (!hostIsPlaying){
+                return -1.0;
+            }
+            double ppqPosition = hostPpqPosition;
+            if (morphStartPpqPosition < 0.0){
+                morphStartPpqPosition = ppqPosition;
+            }
+            if (morphDurationBeats <= 0.0){
+                return 1.0;
+            }
+            return jmax(0.0, ppqPosition - morphStartPpqPosition) / morphDurationBeats;
+        }
+        if (morphDurationMs <= 0.0){
+            return 1.0;
+        }
+        return (Time::getMillisecondCounterHiRes() - morphStartTime) / morphDurationMs;
+    }
+
+    void hiResTimerCallback () override
+    {
+        if (!morphing){
+            return;
+        }
+        double position = getMorphPosition();
+        if (position < 0.0){
+            return;
+        }
+
+        // Queue all events up to the current position
+        int index = nextEventIndex;
+        while ((index < events.size()) && (events[index].position <= position)){
+            const MorphEvent& event = events[index];
+            if (!releasedControls[event.controlIndex]){
+                midiTransmitter->enqueueControlChange(ddrmSynthControlDescriptors[event.controlIndex].ccNumber, event.ccValue);
+            }
+            index++;
+        }
+        nextEventIndex = index;
+
+        if (position >= 1.0){
+            morphing = false;
+            stopTimer();
+            triggerAsyncUpdate();
+        }
+    }
+
+    void handleAsyncUpdate () override
+    {
+        if (onMorphFinished){
+            onMorphFinished();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMMorphEngine)
+};
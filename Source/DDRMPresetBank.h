@@ -10,11 +10,23 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "defines.h"
+#include "DDRMSynthControlDescriptors.h"
 
 class DDRMPresetBank: public ActionBroadcaster
 
 {
 public:
+    /*
+     Besides the raw preset bytes, DDRMPresetBank keeps a cache of the decoded presets so that recalling a
+     preset does not need to decode its bytes again. For each preset the cache holds, in contiguous buffers:
+     - the normalized value of every synth control (DDRM_NUM_SYNTH_CONTROLS floats, -1 for controls not
+       stored in presets, as returned by DDRMPresetDecoder)
+     - the 3-byte MIDI CC frame of every synth control (status byte with channel bits set to 0, CC number
+       and 0-127 value quantised like the audio parameters)
+     The cache is built when a bank is loaded. Writing a preset only invalidates its own entry, which is
+     decoded again the next time it is accessed.
+     */
+    
     DDRMPresetBank ()
     {
         bankFilename = "-";
@@ -34,6 +46,21 @@ public:
     void setPresetBytesAtIndex(int index, DDRMPresetBytes bytes)
     {
         presetsBytes[index] = bytes;
+        cachedEntriesValid[index] = false;
+    }
+    
+    const float* getCachedNormValuesAtIndex(int index)
+    {
+        // Returns pointer to the DDRM_NUM_SYNTH_CONTROLS decoded normalized values of the preset at index
+        updateCacheEntryIfNeeded(index);
+        return &cachedNormValues[index * DDRM_NUM_SYNTH_CONTROLS];
+    }
+    
+    const uint8* getCachedCCFramesAtIndex(int index)
+    {
+        // Returns pointer to the DDRM_NUM_SYNTH_CONTROLS 3-byte CC frames of the preset at index
+        updateCacheEntryIfNeeded(index);
+        return &cachedCCFrames[index * DDRM_NUM_SYNTH_CONTROLS * MIDI_CC_MESSAGE_NUM_BYTES];
     }
     
     int getNumPresetsInBank(){
@@ -70,6 +97,7 @@ public:
             presetsBytes.push_back(currentPresetBytes);
         }
         bankFilename = path.getFileName();
+        rebuildCache();
     }
     
     void loadState(ValueTree state)
@@ -90,6 +118,7 @@ public:
             }
             presetsBytes.push_back(currentPresetBytes);
         }
+        rebuildCache();
     }
     
     ValueTree getState()
@@ -125,5 +154,37 @@ private:
     
     std::vector<DDRMPresetBytes> presetsBytes;
     String bankFilename;
+    
+    std::vector<float> cachedNormValues;  // DDRM_NUM_SYNTH_CONTROLS values per preset
+    std::vector<uint8> cachedCCFrames;  // DDRM_NUM_SYNTH_CONTROLS 3-byte frames per preset
+    std::vector<bool> cachedEntriesValid;
+    
+    void rebuildCache()
+    {
+        cachedNormValues.resize(presetsBytes.size() * DDRM_NUM_SYNTH_CONTROLS);
+        cachedCCFrames.resize(presetsBytes.size() * DDRM_NUM_SYNTH_CONTROLS * MIDI_CC_MESSAGE_NUM_BYTES);
+        cachedEntriesValid.assign(presetsBytes.size(), false);
+        for (int i=0; i<presetsBytes.size(); i++){
+            updateCacheEntryIfNeeded(i);
+        }
+    }
+    
+    void updateCacheEntryIfNeeded(int index)
+    {
+        if (cachedEntriesValid.at(index)){
+            return;
+        }
+        std::array<double, DDRM_NUM_SYNTH_CONTROLS> normValues;
+        DDRMPresetDecoder::getNormValues(presetsBytes[index], normValues);
+        float* entryNormValues = &cachedNormValues[index * DDRM_NUM_SYNTH_CONTROLS];
+        uint8* entryCCFrames = &cachedCCFrames[index * DDRM_NUM_SYNTH_CONTROLS * MIDI_CC_MESSAGE_NUM_BYTES];
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            entryNormValues[i] = (float)normValues[i];
+            entryCCFrames[i * MIDI_CC_MESSAGE_NUM_BYTES] = 0xb0;  // Control change, channel is set when sending
+            entryCCFrames[i * MIDI_CC_MESSAGE_NUM_BYTES + 1] = (uint8)ddrmSynthControlDescriptors[i].ccNumber;
+            entryCCFrames[i * MIDI_CC_MESSAGE_NUM_BYTES + 2] = (uint8)roundToInt(jlimit(0.0, 1.0, normValues[i]) * 127.0);  // Same quantisation as the 0-127 audio parameters
+        }
+        cachedEntriesValid[index] = true;
+    }
 
 };
@@ -0,0 +1,86 @@
+//
+//  DDRMRealtimeTripwire.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+
+/*
+ Debug helpers to check that code which can run in the audio thread (e.g. parameterChanged when the host
+ sends automation) does not allocate memory or take locks.
+
+ DDRM_REALTIME_SECTION marks the rest of the current scope as real-time. While in a real-time section,
+ DDRM_ASSERT_NOT_REALTIME asserts. This is placed before taking locks or allocating in the objects that
+ the processor can call from the real-time path (MIDI transmitter, event bus).
+
+ Global allocation functions are not replaced to catch every allocation: in a plugin that would apply to
+ the whole host process (and clash with other plugins doing the same), so only the marked operations
+ are checked.
+
+ In release builds these macros expand to nothing.
+ */
+
+#if JUCE_DEBUG
+
+class DDRMRealtimeTripwire
+{
+public:
+    static void enterRealtimeSection ()
+    {
+        getRealtimeSectionDepth()++;
+    }
+
+    static void exitRealtimeSection ()
+    {
+        getRealtimeSectionDepth()--;
+    }
+
+    static bool isInRealtimeSection ()
+    {
+        return getRealtimeSectionDepth() > 0;
+    }
+
+    static void check ()
+    {
+        jassert (!isInRealtimeSection());  // Allocation or lock in the real-time path
+    }
+
+private:
+    static int& getRealtimeSectionDepth ()
+    {
+        static thread_local int realtimeSectionDepth = 0;
+        return realtimeSectionDepth;
+    }
+};
+
+class ScopedDDRMRealtimeSection
+{
+public:
+    ScopedDDRMRealtimeSection ()
+    {
+        DDRMRealtimeTripwire::enterRealtimeSection();
+    }
+
+    ~ScopedDDRMRealtimeSection ()
+    {
+        DDRMRealtimeTripwire::exitRealtimeSection();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedDDRMRealtimeSection)
+};
+
+#define DDRM_REALTIME_SECTION const ScopedDDRMRealtimeSection scopedDDRMRealtimeSection;
+#define DDRM_ASSERT_NOT_REALTIME DDRMRealtimeTripwire::check();
+
+#else
+
+#define DDRM_REALTIME_SECTION
+#define DDRM_ASSERT_NOT_REALTIME
+
+#endif
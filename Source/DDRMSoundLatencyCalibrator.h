@@ -0,0 +1,159 @@
+//
+//  DDRMSoundLatencyCalibrator.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "DDRMInterface.h"
+#include "DDRMMidiTransmitter.h"
+#include "DDRMLevelChangeDetector.h"
+
+class DDRMSoundLatencyCalibrator: public ThreadWithProgressWindow
+
+{
+public:
+    /*
+     DDRMSoundLatencyCalibrator measures the time between a CC message being sent to the DDRM and the
+     resulting change of sound arriving at the audio input of the plugin. It needs the DDRM audio output
+     connected to the plugin input and a note being held on the DDRM.
+
+     The channel level of both DDRM channels is used as the test control. The input level is first
+     measured with both levels at 0 and at 127 to set the detection threshold half way. Then, for each
+     trial, levels are set to 0 and, once the sound has settled, set to 127 while the level change
+     detector is armed. The sound latency is the median of the time between the CC messages being sent and
+     the level change being detected.
+
+     Echo acknowledgement of the transmitter is disabled while calibrating. The channel levels are left at
+     127 and should be restored by the caller (e.g. with DdrmtimbreSpaceAudioProcessor::sendControlsToSynth).
+     */
+
+    DDRMSoundLatencyCalibrator (DDRMMidiTransmitter* t, DDRMInterface* i, DDRMLevelChangeDetector* d)
+        : ThreadWithProgressWindow ("Calibrating sound latency...", true, true)
+    {
+        midiTransmitter = t;
+        levelChangeDetector = d;
+        succeeded = false;
+        measuredLatencyMs = 0.0f;
+
+        const char* levelControlIDs[] = {"DDRM_LEVEL_VCA_1", "DDRM_LEVEL_VCA_2"};
+        for (const char* controlID: levelControlIDs){
+            int controlIndex = i->getControlIndexForID(controlID);
+            if (controlIndex > -1){
+                levelCCNumbers.add(ddrmSynthControlDescriptors[controlIndex].ccNumber);
+            }
+        }
+    }
+
+    ~DDRMSoundLatencyCalibrator ()
+    {
+    }
+
+    void run () override
+    {
+        bool wasEchoAcknowledgementEnabled = midiTransmitter->isEchoAcknowledgementEnabled();
+        midiTransmitter->setEchoAcknowledgementEnabled(false);
+
+        if (measureLevels()){
+            measureLatency();
+        }
+
+        levelChangeDetector->stop();
+        midiTransmitter->setEchoAcknowledgementEnabled(wasEchoAcknowledgementEnabled);
+    }
+
+    bool succeeded;
+    float measuredLatencyMs;
+    String errorMessage;
+
+private:
+
+    DDRMMidiTransmitter* midiTransmitter;
+    DDRMLevelChangeDetector* levelChangeDetector;
+    Array<int> levelCCNumbers;
+    float detectionThreshold;
+
+    double sendLevel (int ccValue)
+    {
+        // Sets the level of both DDRM channels and returns the time at which the first message was sent
+        double sendTime = -1.0;
+        for (int i=0; i<levelCCNumbers.size(); i++){
+            double time = midiTransmitter->sendControlChangeNow(levelCCNumbers[i], ccValue);
+            if (sendTime < 0.0){
+                sendTime = time;
+            }
+        }
+        return sendTime;
+    }
+
+    float measureLevel (int ccValue)
+    {
+        sendLevel(ccValue);
+        Thread::sleep(SOUND_LATENCY_CALIBRATION_SETTLE_MS);
+        levelChangeDetector->startMeasuringLevel();
+        Thread::sleep(SOUND_LATENCY_CALIBRATION_MEASURE_MS);
+        float level = levelChangeDetector->getMeasuredLevel();
+        levelChangeDetector->stop();
+        return level;
+    }
+
+    bool measureLevels ()
+    {
+        setStatusMessage("Hold a note on the DDRM. Measuring levels...");
+        float lowLevel = measureLevel(0);
+        float highLevel = measureLevel(127);
+        if (threadShouldExit()){
+            errorMessage = "Calibration cancelled.";
+            return false;
+        }
+        if ((highLevel < SOUND_LATENCY_CALIBRATION_MIN_LEVEL) || (highLevel < lowLevel * SOUND_LATENCY_CALIBRATION_MIN_LEVEL_RATIO)){
+            errorMessage = "No level change detected on the audio input. Make sure the DDRM audio output is connected to the plugin input and hold a note while calibrating.";
+            return false;
+        }
+        detectionThreshold = 0.5f * (lowLevel + highLevel);
+        return true;
+    }
+
+    void measureLatency ()
+    {
+        setStatusMessage("Hold a note on the DDRM. Measuring latency...");
+        std::vector<double> latencies;
+        for (int i=0; i<SOUND_LATENCY_CALIBRATION_NUM_TRIALS; i++){
+            if (threadShouldExit()){
+                errorMessage = "Calibration cancelled.";
+                return;
+            }
+            setProgress((double)i / SOUND_LATENCY_CALIBRATION_NUM_TRIALS);
+            sendLevel(0);
+            Thread::sleep(SOUND_LATENCY_CALIBRATION_SETTLE_MS);
+            levelChangeDetector->arm(detectionThreshold);
+            double sendTime = sendLevel(127);
+            double startTime = Time::getMillisecondCounterHiRes();
+            while (!levelChangeDetector->hasDetected() && (Time::getMillisecondCounterHiRes() - startTime < SOUND_LATENCY_CALIBRATION_SETTLE_MS)){
+                Thread::sleep(1);
+            }
+            if (levelChangeDetector->hasDetected() && (levelChangeDetector->getDetectionTime() >= sendTime)){
+                // Detections before the level was sent are not caused by it (e.g. noise or the note being played)
+                latencies.push_back(levelChangeDetector->getDetectionTime() - sendTime);
+            }
+            levelChangeDetector->stop();
+        }
+
+        if (latencies.size() < SOUND_LATENCY_CALIBRATION_NUM_TRIALS / 2){
+            errorMessage = "The level change was not detected reliably. Hold a sustained note on the DDRM while calibrating.";
+            return;
+        }
+        std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2, latencies.end());
+        measuredLatencyMs = (float)latencies[latencies.size() / 2];
+        succeeded = true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMSoundLatencyCalibrator)
+};
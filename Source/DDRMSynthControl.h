@@ -10,20 +10,22 @@
 
 #include <array>
 #include "defines.h"
+#include "DDRMSynthControlDescriptors.h"
 
 class DDRMSynthControl
 
 {
 public:
-    DDRMSynthControl (const String& _ID, const String& _name, int _ccNumber, int _byteNumber, int _byteNumberVoiceFile, int _channelNumber, bool _includeOnTimbreSpace)
+    DDRMSynthControl (const DDRMSynthControlDescriptor& descriptor)
     {
-        ID = _ID;
-        name = _name;
-        ccNumber = _ccNumber;
-        byteNumber = _byteNumber;
-        byteNumberVoiceFile = _byteNumberVoiceFile;
-        channelNumber = _channelNumber;
-        includeOnTimbreSpace = _includeOnTimbreSpace;
+        ID = String(descriptor.ID);
+        name = String(descriptor.name);
+        ccNumber = descriptor.ccNumber;
+        byteNumber = descriptor.presetByteNumber;
+        byteNumberVoiceFile = descriptor.voiceByteNumber;
+        channelNumber = descriptor.channelNumber;
+        includeOnTimbreSpace = descriptor.includeOnTimbreSpace;
+        presetCodec = descriptor.presetCodec;
     }
     
     ~DDRMSynthControl ()
@@ -85,26 +87,13 @@ public:
         // Return parameter value normalized [0.0-1.0] taking it from corresponding spot in DDRMPresetBytes array
         // If parameter is not represented in DDRMPresetBytes, this will return -1
         
-        if ((byteNumber > -1) && (byteNumber < DDRM_PRESET_NUM_BYTES)){
+        if ((presetCodec == DDRMPresetCodec::byte) && (byteNumber > -1) && (byteNumber < DDRM_PRESET_NUM_BYTES)){
             return jlimit(0.0, 1.0, (double)bytes[byteNumber] / 255.0);
         }
         
-        if (ID == "DDRM_GLIDE_MODE_GLIDE"){
-            // Custom behaviour for DDRM_GLIDE_MODE_GLIDE
-            // Note that some parameter info is hardcoded here and should be manually changed if needed
-            // b72=255 & b80=0 -> portamento, b72=0 & b80=255 -> glissando, b72=0 & b80 = 0 -> none
-            
-            bool portamentoOn = bytes[72] > 127;  // Note range is 0-255 here
-            bool glissandoOn = bytes[80] > 127; // Note range is 0-255 here
-            
-            if (portamentoOn && !glissandoOn) {
-                return 0.0; // Portamento on
-            } else if (!portamentoOn && glissandoOn) {
-                return 1.0; // Glissando on
-            } else {
-                // If both off or both on, we consider none is active
-                return 0.5; // Both off
-            }
+        if (presetCodec == DDRMPresetCodec::glideMode){
+            // Custom behaviour for DDRM_GLIDE_MODE_GLIDE (see DDRMPresetCodec)
+            return DDRMPresetDecoder::getGlideModeNormValue(bytes);
         }
         
         return -1.0;
@@ -128,25 +117,22 @@ public:
             bytes[byteNumber] = byteValue;
         }
         
-        if (ID == "DDRM_GLIDE_MODE_GLIDE"){
-            // Custom behaviour for DDRM_GLIDE_MODE_GLIDE
-            // Note that some parameter info is hardcoded here and should be manually changed if needed
-            // b72=255 & b80=0 -> portamento, b72=0 & b80=255 -> glissando, b72=0 & b80 = 0 -> none
-            
+        if (presetCodec == DDRMPresetCodec::glideMode){
+            // Custom behaviour for DDRM_GLIDE_MODE_GLIDE (see DDRMPresetCodec)
             int midiValue = norm2midi((double)normValue);
             
             if (midiValue < 32) { // Follow DDRM MIDI spec
                 // Set to Portamento
-                bytes[72] = 255;
-                bytes[80] = 0;
+                bytes[DDRM_GLIDE_MODE_PORTAMENTO_BYTE_NUMBER] = 255;
+                bytes[DDRM_GLIDE_MODE_GLISSANDO_BYTE_NUMBER] = 0;
             } else if (midiValue >= 32 && midiValue < 85) {
                 // Set to None
-                bytes[72] = 255;
-                bytes[80] = 255;
+                bytes[DDRM_GLIDE_MODE_PORTAMENTO_BYTE_NUMBER] = 255;
+                bytes[DDRM_GLIDE_MODE_GLISSANDO_BYTE_NUMBER] = 255;
             } else if (midiValue >= 85) {
                 // Set to glissando
-                bytes[72] = 0;
-                bytes[80] = 255;
+                bytes[DDRM_GLIDE_MODE_PORTAMENTO_BYTE_NUMBER] = 0;
+                bytes[DDRM_GLIDE_MODE_GLISSANDO_BYTE_NUMBER] = 255;
             }
         }
     }
@@ -169,4 +155,5 @@ private:
     int byteNumberVoiceFile;
     int channelNumber;
     bool includeOnTimbreSpace;
+    DDRMPresetCodec presetCodec;
 };
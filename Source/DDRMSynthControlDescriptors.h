@@ -0,0 +1,269 @@
+//
+//  DDRMSynthControlDescriptors.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <utility>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+
+/*
+ Compile-time description of all DDRM synth controls. This table is the single source of truth for
+ control metadata: audio parameters and their listeners (PluginProcessor), DDRMSynthControl objects
+ (DDRMInterface) and the lookup tables below are all generated from it.
+ 
+ The position of a control in ddrmSynthControlDescriptors is the control index used everywhere else
+ (see DDRMInterface::getDDRMSynthControlAtIndex). Keep the order stable as it also determines the order
+ of the audio parameters exposed to the host.
+ */
+
+enum class DDRMPresetCodec {
+    none,  // Control is not stored in preset bytes
+    byte,  // Control value is stored in a single byte (0-255)
+    glideMode  // Glide mode is stored in two bytes: b72=255 & b80=0 -> portamento, b72=0 & b80=255 -> glissando, b72=0 & b80 = 0 -> none
+};
+
+struct DDRMSynthControlDescriptor {
+    const char* ID;
+    const char* name;
+    int ccNumber;
+    int presetByteNumber;  // -1 if not stored in preset bytes
+    int voiceByteNumber;  // -1 if not stored in voice bytes
+    int channelNumber;  // 1 or 2, -1 if control does not belong to a DDRM channel
+    bool includeOnTimbreSpace;
+    DDRMPresetCodec presetCodec;
+};
+
+constexpr DDRMSynthControlDescriptor ddrmSynthControlDescriptors[] = {
+    // ID, name, CC number, preset byte, voice byte, channel, include on timbre space, preset codec
+    // --> Start auto-generated code A
+    {"DDRM_SPEED_VCO_1", "Ch I: PWM Speed", 40, 0, 0, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_PWM_VCO_1", "Ch I: PWM Amount", 41, 1, 1, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_PW_VCO_1", "Ch I: PW", 42, 2, 2, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_SQR_VCO_1", "Ch I: Square", 43, 73, 24, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_SAW_VCO_1", "Ch I: Sawtooth", 44, 74, 25, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_NOISE_VCO_1", "Ch I: Noise", 45, 3, 3, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_HPF_VCF_1", "Ch I: HPF", 46, 4, 4, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_RESh_VCF_1", "Ch I: RESh", 47, 5, 5, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_LPF_VCF_1", "Ch I: LPF", 48, 6, 6, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_RESl_VCF_1", "Ch I: RESl", 49, 7, 7, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_IL_VCF_1", "Ch I: VCF IL", 50, 8, 8, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_AL_VCF_1", "Ch I: VCF AL", 51, 9, 9, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_A_VCF_1", "Ch I: VCF A", 52, 10, 10, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_D_VCF_1", "Ch I: VCF D", 53, 11, 11, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_R_VCF_1", "Ch I: VCF R", 54, 12, 12, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_VCF_VCA_1", "Ch I: VCF Level", 55, 13, 13, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_SINE__VCA_1", "Ch I: Sine Level", 56, 14, 14, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_A_VCA_1", "Ch I: VCA A", 57, 15, 15, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_D_VCA_1", "Ch I: VCA D", 58, 16, 16, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_S_VCA_1", "Ch I: VCA S", 59, 17, 17, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_R_VCA_1", "Ch I: VCA R", 60, 18, 18, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_LEVEL_VCA_1", "Ch I: Channel Level", 61, 19, 19, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_INIT_BR_TOUCH_1", "Ch I: Initial Brilliance", 62, 20, 20, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_INIT_LEV_TOUCH_1", "Ch I: Initial Level", 63, 21, 21, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_AT_BR_TOUCH_1", "Ch I: After Brilliance", 65, 22, 22, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_AT_LEV_TOUCH_1", "Ch I: After Level", 66, 23, 23, 1, true, DDRMPresetCodec::byte},
+    {"DDRM_SPEED_VCO_2", "Ch II: PWM Speed", 67, 30, 0, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_PWM_VCO_2", "Ch II: PWM Amount", 68, 31, 1, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_PW_VCO_2", "Ch II: PW", 69, 32, 2, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_SQR_VCO_2", "Ch II: Square", 70, 76, 24, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_SAW_VCO_2", "Ch II: Sawtooth", 71, 75, 25, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_NOISE_VCO_2", "Ch II: Noise", 72, 33, 3, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_HPF_VCF_2", "Ch II: HPF", 73, 34, 4, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_RESh_VCF_2", "Ch II: RESh", 119, 35, 5, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_LPF_VCF_2", "Ch II: LPF", 75, 36, 6, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_RESl_VCF_2", "Ch II: RESl", 76, 37, 7, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_IL_VCF_2", "Ch II: VCF IL", 77, 38, 8, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_AL_VCF_2", "Ch II: VCF AL", 78, 39, 9, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_A_VCF_2", "Ch II: VCF A", 79, 24, 10, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_D_VCF_2", "Ch II: VCF D", 80, 25, 11, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_R_VCF_2", "Ch II: VCF R", 81, 26, 12, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_VCF_VCA_2", "Ch II: VCF Level", 82, 27, 13, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_SINE__VCA_2", "Ch II: Sine Level", 83, 28, 14, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_A_VCA_2", "Ch II: VCA A", 84, 29, 15, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_D_VCA_2", "Ch II: VCA D", 85, 40, 16, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_S_VCA_2", "Ch II: VCA S", 86, 41, 17, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_R_VCA_2", "Ch II: VCA R", 87, 42, 18, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_LEVEL_VCA_2", "Ch II: Channel Level", 88, 43, 19, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_INIT_BR_TOUCH_2", "Ch II: Initial Brilliance", 89, 44, 20, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_INIT_LEV_TOUCH_2", "Ch II: Initial Level", 90, 45, 21, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_AT_BR_TOUCH_2", "Ch II: After Brilliance", 91, 46, 22, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_AT_LEV_TOUCH_2", "Ch II: After Level", 92, 47, 23, 2, true, DDRMPresetCodec::byte},
+    {"DDRM_COARSE_PITCH", "Pitch Coarse", 93, 77, -1, -1, false, DDRMPresetCodec::byte},
+    {"DDRM_FINE_PITCH", "Pitch Fine", 94, 78, -1, -1, false, DDRMPresetCodec::byte},
+    {"DDRM_DETUNE_CH2_PITCH", "Detune Ch II", 95, 79, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_FEET_1_FEET", "Feet I", 102, 48, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_FEET_2_FEET", "Feet II", 103, 49, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_FUNCTION_SUB_OSC", "Sub Osc Function", 104, 50, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_SPEED_SUB_OSC", "Sub Osc Speed", 105, 51, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_VCO_SUB_OSC", "Sub Osc VCO Amount", 106, 52, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_VCF_SUB_OSC", "Sub Osc VCF Amount", 107, 53, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_VCA_SUB_OSC", "Sub Osc VCA Amount", 108, 54, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_MIX", "Mix", 8, 55, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_BRILL", "Brilliance", 109, 56, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_RESSO", "Ressonance", 110, 57, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_INITIAL_TOUCH", "Initial Pitch Bend", 111, 58, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_SPEED_TOUCH", "Touch Response Sub Osc Speed", 112, 59, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_VCO_TOUCH", "Touch Response Sub Osc VCO Amount", 113, 60, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_VCF_TOUCH", "Touch Response Sub Osc VCF Amount", 114, 61, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_BR_LOW_KBRD", "Brilliance Low", 115, 62, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_BR_HIGH_KBRD", "Brilliance High", 116, 63, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_LEV_LOW_KBRD", "Level Low", 117, 64, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_LEV_HIGH_KBRD", "Level High", 118, 65, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_GLIDE_MODE_GLIDE", "Glide Mode", 39, -1, -1, -1, true, DDRMPresetCodec::glideMode},
+    {"DDRM_GLIDE_TIME_GLIDE", "Glide Time", 5, 66, -1, -1, true, DDRMPresetCodec::byte},
+    {"DDRM_SUSTAIN_MODE", "Sustain Mode", 9, -1, -1, -1, false, DDRMPresetCodec::none},
+    {"DDRM_SUSTAIN_TIME", "Sustain Time", 11, -1, -1, -1, false, DDRMPresetCodec::none}
+    // --> End auto-generated code A
+};
+
+constexpr int DDRM_NUM_SYNTH_CONTROLS = sizeof(ddrmSynthControlDescriptors) / sizeof(ddrmSynthControlDescriptors[0]);
+
+#define DDRM_GLIDE_MODE_PORTAMENTO_BYTE_NUMBER 72
+#define DDRM_GLIDE_MODE_GLISSANDO_BYTE_NUMBER 80
+
+//==============================================================================
+// Compile-time lookup tables
+
+template <int Size>
+struct DDRMControlIndexTable {
+    int indexes[Size];
+    int numIndexes;
+    
+    constexpr int operator[] (int position) const
+    {
+        return indexes[position];
+    }
+};
+
+constexpr DDRMControlIndexTable<128> makeCCNumberToControlIndexTable ()
+{
+    // CC number -> control index (-1 if no control assigned). If more than one control has the same
+    // CC number, the first one in the descriptors table is used.
+    DDRMControlIndexTable<128> table = {};
+    table.numIndexes = 128;
+    for (int i=0; i<128; i++){
+        table.indexes[i] = -1;
+    }
+    for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+        int ccNumber = ddrmSynthControlDescriptors[i].ccNumber;
+        if ((ccNumber >= 0) && (ccNumber < 128) && (table.indexes[ccNumber] == -1)){
+            table.indexes[ccNumber] = i;
+        }
+    }
+    return table;
+}
+
+constexpr DDRMControlIndexTable<DDRM_PRESET_NUM_BYTES> makePresetByteNumberToControlIndexTable ()
+{
+    // Preset byte number -> control index (-1 if byte is not used by any control)
+    DDRMControlIndexTable<DDRM_PRESET_NUM_BYTES> table = {};
+    table.numIndexes = DDRM_PRESET_NUM_BYTES;
+    for (int i=0; i<DDRM_PRESET_NUM_BYTES; i++){
+        table.indexes[i] = -1;
+    }
+    for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+        const DDRMSynthControlDescriptor& descriptor = ddrmSynthControlDescriptors[i];
+        if (descriptor.presetCodec == DDRMPresetCodec::byte){
+            table.indexes[descriptor.presetByteNumber] = i;
+        } else if (descriptor.presetCodec == DDRMPresetCodec::glideMode){
+            table.indexes[DDRM_GLIDE_MODE_PORTAMENTO_BYTE_NUMBER] = i;
+            table.indexes[DDRM_GLIDE_MODE_GLISSANDO_BYTE_NUMBER] = i;
+        }
+    }
+    return table;
+}
+
+constexpr DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> makeChannelControlIndexTable (int channel)
+{
+    // Indexes of the controls of a DDRM channel (use channel -1 for the controls not belonging to a channel)
+    DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> table = {};
+    table.numIndexes = 0;
+    for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+        if (ddrmSynthControlDescriptors[i].channelNumber == channel){
+            table.indexes[table.numIndexes] = i;
+            table.numIndexes++;
+        }
+    }
+    return table;
+}
+
+constexpr DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> makeTimbreSpaceControlIndexTable ()
+{
+    // Indexes of the controls to be included in the timbre space
+    DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> table = {};
+    table.numIndexes = 0;
+    for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+        if (ddrmSynthControlDescriptors[i].includeOnTimbreSpace){
+            table.indexes[table.numIndexes] = i;
+            table.numIndexes++;
+        }
+    }
+    return table;
+}
+
+constexpr DDRMControlIndexTable<128> ddrmCCNumberToControlIndex = makeCCNumberToControlIndexTable();
+constexpr DDRMControlIndexTable<DDRM_PRESET_NUM_BYTES> ddrmPresetByteNumberToControlIndex = makePresetByteNumberToControlIndexTable();
+constexpr DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> ddrmChannel1ControlIndexes = makeChannelControlIndexTable(1);
+constexpr DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> ddrmChannel2ControlIndexes = makeChannelControlIndexTable(2);
+constexpr DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> ddrmOtherChannelControlIndexes = makeChannelControlIndexTable(-1);
+constexpr DDRMControlIndexTable<DDRM_NUM_SYNTH_CONTROLS> ddrmTimbreSpaceControlIndexes = makeTimbreSpaceControlIndexTable();
+
+static_assert(ddrmChannel1ControlIndexes.numIndexes == ddrmChannel2ControlIndexes.numIndexes, "DDRM channels should have the same number of controls");
+
+//==============================================================================
+// Preset codec specialised per control
+
+class DDRMPresetDecoder
+{
+public:
+    template <int controlIndex>
+    static double getNormValue (const DDRMPresetBytes& bytes)
+    {
+        // Return parameter value normalized [0.0-1.0] taking it from corresponding spot in DDRMPresetBytes array
+        // If parameter is not represented in DDRMPresetBytes, this will return -1
+        // As the descriptor is known at compile time, the compiler keeps only the branch of the codec used by the control
+        constexpr DDRMSynthControlDescriptor descriptor = ddrmSynthControlDescriptors[controlIndex];
+        if (descriptor.presetCodec == DDRMPresetCodec::byte){
+            return jlimit(0.0, 1.0, (double)bytes[descriptor.presetByteNumber] / 255.0);
+        } else if (descriptor.presetCodec == DDRMPresetCodec::glideMode){
+            return getGlideModeNormValue(bytes);
+        }
+        return -1.0;
+    }
+    
+    static void getNormValues (const DDRMPresetBytes& bytes, std::array<double, DDRM_NUM_SYNTH_CONTROLS>& normValues)
+    {
+        // Decodes the normalized values of all controls in one go
+        getNormValues(bytes, normValues, std::make_integer_sequence<int, DDRM_NUM_SYNTH_CONTROLS>());
+    }
+    
+    static double getGlideModeNormValue (const DDRMPresetBytes& bytes)
+    {
+        bool portamentoOn = bytes[DDRM_GLIDE_MODE_PORTAMENTO_BYTE_NUMBER] > 127;  // Note range is 0-255 here
+        bool glissandoOn = bytes[DDRM_GLIDE_MODE_GLISSANDO_BYTE_NUMBER] > 127; // Note range is 0-255 here
+        
+        if (portamentoOn && !glissandoOn) {
+            return 0.0; // Portamento on
+        } else if (!portamentoOn && glissandoOn) {
+            return 1.0; // Glissando on
+        } else {
+            // If both off or both on, we consider none is active
+            return 0.5; // Both off
+        }
+    }
+    
+private:
+    template <int... controlIndexes>
+    static void getNormValues (const DDRMPresetBytes& bytes, std::array<double, DDRM_NUM_SYNTH_CONTROLS>& normValues, std::integer_sequence<int, controlIndexes...>)
+    {
+        int unused[] = { (normValues[controlIndexes] = getNormValue<controlIndexes>(bytes), 0)... };
+        ignoreUnused(unused);
+    }
+};
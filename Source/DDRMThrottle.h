@@ -0,0 +1,87 @@
+//
+//  DDRMThrottle.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <functional>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+
+class DDRMThrottle: private Timer
+
+{
+public:
+    /*
+     Rate limiter with leading and trailing edge delivery for expensive updates driven by fast streams of
+     requests (e.g. timbre space mouse drags or automation). The object which owns the throttle keeps the
+     newest requested state and calls request() each time it changes. The callback is run:
+     - immediately (leading edge) if it has not run within the last interval
+     - otherwise once at the end of the interval (trailing edge), so the newest state is always delivered
+       even if requests stop inside the interval
+     The callback never runs more than once per interval. Elapsed times are measured with the
+     high resolution millisecond counter and the trailing edge is scheduled with a Timer so that the
+     callback always runs in the message thread.
+     */
+
+    DDRMThrottle (int intervalMs, std::function<void()> callback)
+        : throttleIntervalMs (intervalMs), throttledCallback (callback)
+    {
+        lastRunTime = 0.0;
+        hasPendingRequest = false;
+    }
+
+    ~DDRMThrottle ()
+    {
+        stopTimer();
+    }
+
+    void request ()
+    {
+        // Should be called from the message thread
+        double now = Time::getMillisecondCounterHiRes();
+        if (!hasPendingRequest && (now - lastRunTime >= throttleIntervalMs)){
+            run(now);  // Leading edge
+        } else if (!hasPendingRequest){
+            hasPendingRequest = true;
+            startTimer(jmax(1, (int)std::ceil(lastRunTime + throttleIntervalMs - now)));
+        }
+        // If a request is already pending, the trailing edge will deliver the newest state
+    }
+
+    void cancel ()
+    {
+        // Drops the pending request (if any)
+        stopTimer();
+        hasPendingRequest = false;
+    }
+
+private:
+
+    int throttleIntervalMs;
+    std::function<void()> throttledCallback;
+    double lastRunTime;
+    bool hasPendingRequest;
+
+    void timerCallback () override
+    {
+        // Trailing edge
+        stopTimer();
+        if (hasPendingRequest){
+            run(Time::getMillisecondCounterHiRes());
+        }
+    }
+
+    void run (double now)
+    {
+        hasPendingRequest = false;
+        lastRunTime = now;
+        throttledCallback();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DDRMThrottle)
+};
@@ -88,7 +88,7 @@ private:
 
 
 class DDRMToneSelectorComponent: public Component,
-                                 public ActionListener,
+                                 public DDRMEventListener,
                                  public Button::Listener
 
 {
@@ -213,7 +213,7 @@ public:
     
     ~DDRMToneSelectorComponent ()
     {
-        processor->ddrmInterface->removeActionListener(this);  // Stop receivng messages from DDRMInterface
+        processor->ddrmInterface->removeEventListener(this);  // Stop receivng events from DDRMInterface
     }
     
     void initialize (DdrmtimbreSpaceAudioProcessor* p)
@@ -225,7 +225,10 @@ public:
         allRow2ButtonsAreOff = true;
         
         // Set up listeners
-        processor->ddrmInterface->addActionListener(this);  // Receive messages from DDRMInterface
+        processor->ddrmInterface->addEventListener(this, {DDRMEvent::setToneSelectorButtonsRow1Off,
+                                                          DDRMEvent::setToneSelectorButtonsRow2Off,
+                                                          DDRMEvent::setToneSelectorButtonsRow1,
+                                                          DDRMEvent::setToneSelectorButtonsRow2});  // Receive events from DDRMInterface
         
         // Set initial state from processor (if any)
         setStateFromProcessor();
@@ -350,19 +353,19 @@ public:
         throw std::invalid_argument("Invalid name/row argument");
     }
     
-    void actionListenerCallback (const String &message) override
+    void ddrmEventCallback (DDRMEvent event) override
     {
-        if (message.startsWith(String(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1_OFF))){
+        if (event == DDRMEvent::setToneSelectorButtonsRow1Off){
             if (!allRow1ButtonsAreOff){
                 setRow1ButtonsToOff();
             }
         }
-        else if (message.startsWith(String(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2_OFF))){
+        else if (event == DDRMEvent::setToneSelectorButtonsRow2Off){
             if (!allRow2ButtonsAreOff){
                 setRow2ButtonsToOff();
             }
         }
-        else if (message.startsWith(String(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1))){
+        else if (event == DDRMEvent::setToneSelectorButtonsRow1){
             setRow1ButtonsToOff();
             String toneName = processor->ddrmInterface->getSelectedToneSelector(1);
             if (toneName != String(EMPTY_TONE_SELECTOR_NAME)){
@@ -370,7 +373,7 @@ public:
                 button->setToggleState(true, NotificationType::dontSendNotification);
             }
         }
-        else if (message.startsWith(String(ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2))){
+        else if (event == DDRMEvent::setToneSelectorButtonsRow2){
             setRow2ButtonsToOff();
             String toneName = processor->ddrmInterface->getSelectedToneSelector(2);
             if (toneName != String(EMPTY_TONE_SELECTOR_NAME)){
@@ -103,10 +103,57 @@ public:
             midiDevicesSubMenu.addItem (autoScanMenuOptionID, "Auto-scan MIDI devices", true, autoScanTicked);
             midiDevicesSubMenu.addItem (MENU_OPTION_MIDI_SCAN_NOW, "Scan devices now", scanNowEnabled, false);
             
+            bool hostOutputTicked = processor->midiTransmitter->isHostOutputEnabled();
+            int hostOutputMenuOptionID = hostOutputTicked ? MENU_OPTION_MIDI_OUTPUT_TO_HOST_OFF : MENU_OPTION_MIDI_OUTPUT_TO_HOST_ON;
+            
+            PopupMenu midiLinkRateSubMenu;
+            int linkRate = processor->midiTransmitter->getLinkRate();
+            midiLinkRateSubMenu.addItem (MENU_OPTION_MIDI_LINK_RATE_DIN, "DIN MIDI (31.25 kbaud)", true, linkRate == MIDI_LINK_RATE_DIN);
+            midiLinkRateSubMenu.addItem (MENU_OPTION_MIDI_LINK_RATE_USB, "USB MIDI", true, linkRate == MIDI_LINK_RATE_USB);
+            midiLinkRateSubMenu.addItem (MENU_OPTION_MIDI_LINK_RATE_UNLIMITED, "Unlimited", true, linkRate == MIDI_LINK_RATE_UNLIMITED);
+            midiLinkRateSubMenu.addSeparator();
+            midiLinkRateSubMenu.addItem (MENU_OPTION_MIDI_LINK_CALIBRATE, "Calibrate MIDI link...", true, processor->hasMidiLinkCalibrationForCurrentDevice());
+            midiLinkRateSubMenu.addItem (MENU_OPTION_SOUND_LATENCY_CALIBRATE, "Calibrate sound latency...", true, processor->getSoundLatencyMsForCurrentDevice() >= 0.0);
+            
+            PopupMenu automationSubMenu;
+            int automationRate = processor->automationDecimator->getControlRate();
+            bool slewLimitTicked = processor->automationDecimator->getSlewLimit() > 0;
+            int slewLimitMenuOptionID = slewLimitTicked ? MENU_OPTION_AUTOMATION_SLEW_OFF : MENU_OPTION_AUTOMATION_SLEW_ON;
+            automationSubMenu.addItem (MENU_OPTION_AUTOMATION_RATE_25, "25 Hz", true, automationRate == 25);
+            automationSubMenu.addItem (MENU_OPTION_AUTOMATION_RATE_50, "50 Hz", true, automationRate == 50);
+            automationSubMenu.addItem (MENU_OPTION_AUTOMATION_RATE_100, "100 Hz", true, automationRate == 100);
+            automationSubMenu.addSeparator();
+            automationSubMenu.addItem (slewLimitMenuOptionID, "Smooth large jumps", true, slewLimitTicked);
+            
+            PopupMenu presetMorphSubMenu;
+            float morphBeats = processor->presetMorphBeats;
+            bool easeTicked = processor->presetMorphCurve == DDRMMorphCurve::easeInOut;
+            int easeMenuOptionID = easeTicked ? MENU_OPTION_PRESET_MORPH_EASE_OFF : MENU_OPTION_PRESET_MORPH_EASE_ON;
+            presetMorphSubMenu.addItem (MENU_OPTION_PRESET_MORPH_OFF, "Off", true, morphBeats == 0.0);
+            presetMorphSubMenu.addItem (MENU_OPTION_PRESET_MORPH_1_BEAT, "1 beat", true, morphBeats == 1.0);
+            presetMorphSubMenu.addItem (MENU_OPTION_PRESET_MORPH_2_BEATS, "2 beats", true, morphBeats == 2.0);
+            presetMorphSubMenu.addItem (MENU_OPTION_PRESET_MORPH_4_BEATS, "4 beats", true, morphBeats == 4.0);
+            presetMorphSubMenu.addItem (MENU_OPTION_PRESET_MORPH_8_BEATS, "8 beats", true, morphBeats == 8.0);
+            presetMorphSubMenu.addSeparator();
+            presetMorphSubMenu.addItem (easeMenuOptionID, "Ease in/out", true, easeTicked);
+            
+            PopupMenu timbreSpaceSubMenu;
+            bool rasterTicked = processor->timbreSpaceEngine->isInterpolationRasterEnabled();
+            int rasterMenuOptionID = rasterTicked ? MENU_OPTION_TIMBRE_SPACE_RASTER_OFF : MENU_OPTION_TIMBRE_SPACE_RASTER_ON;
+            bool snapTicked = processor->timbreSpaceEngine->isSnapToNearestPresetEnabled();
+            int snapMenuOptionID = snapTicked ? MENU_OPTION_TIMBRE_SPACE_SNAP_OFF : MENU_OPTION_TIMBRE_SPACE_SNAP_ON;
+            timbreSpaceSubMenu.addItem (rasterMenuOptionID, "Precomputed interpolation", true, rasterTicked);
+            timbreSpaceSubMenu.addItem (snapMenuOptionID, "Snap to nearest preset", true, snapTicked);
+            
             PopupMenu m;
             m.setLookAndFeel(&customLookAndFeel);
             m.addSubMenu ("Zoom", zoomSubMenu);
             m.addSubMenu ("MIDI device scan", midiDevicesSubMenu);
+            m.addSubMenu ("MIDI output rate", midiLinkRateSubMenu);
+            m.addSubMenu ("Automation rate", automationSubMenu);
+            m.addSubMenu ("Preset morph", presetMorphSubMenu);
+            m.addSubMenu ("Timbre space", timbreSpaceSubMenu);
+            m.addItem (hostOutputMenuOptionID, "Send MIDI through host", processor->producesMidi(), hostOutputTicked);
             selectedActionID = m.showAt(button);
             
         }
@@ -136,6 +183,52 @@ public:
             processor->setMidiDevicesAutoScan(true);
         } else if (actionID == MENU_OPTION_MIDI_SCAN_NOW){
             processor->triggerMidiDevicesScan();
+        } else if (actionID == MENU_OPTION_MIDI_LINK_RATE_DIN){
+            processor->setMidiOutputLinkRate(MIDI_LINK_RATE_DIN);
+        } else if (actionID == MENU_OPTION_MIDI_LINK_RATE_USB){
+            processor->setMidiOutputLinkRate(MIDI_LINK_RATE_USB);
+        } else if (actionID == MENU_OPTION_MIDI_LINK_RATE_UNLIMITED){
+            processor->setMidiOutputLinkRate(MIDI_LINK_RATE_UNLIMITED);
+        } else if (actionID == MENU_OPTION_MIDI_OUTPUT_TO_HOST_ON){
+            processor->setMidiOutputToHost(true);
+        } else if (actionID == MENU_OPTION_MIDI_OUTPUT_TO_HOST_OFF){
+            processor->setMidiOutputToHost(false);
+        } else if (actionID == MENU_OPTION_MIDI_LINK_CALIBRATE){
+            processor->calibrateMidiOutputLink();
+        } else if (actionID == MENU_OPTION_SOUND_LATENCY_CALIBRATE){
+            processor->calibrateSoundLatency();
+        } else if (actionID == MENU_OPTION_AUTOMATION_RATE_25){
+            processor->setAutomationControlRate(25);
+        } else if (actionID == MENU_OPTION_AUTOMATION_RATE_50){
+            processor->setAutomationControlRate(50);
+        } else if (actionID == MENU_OPTION_AUTOMATION_RATE_100){
+            processor->setAutomationControlRate(100);
+        } else if (actionID == MENU_OPTION_AUTOMATION_SLEW_ON){
+            processor->setAutomationSlewLimitEnabled(true);
+        } else if (actionID == MENU_OPTION_AUTOMATION_SLEW_OFF){
+            processor->setAutomationSlewLimitEnabled(false);
+        } else if (actionID == MENU_OPTION_PRESET_MORPH_OFF){
+            processor->setPresetMorph(0.0, processor->presetMorphCurve);
+        } else if (actionID == MENU_OPTION_PRESET_MORPH_1_BEAT){
+            processor->setPresetMorph(1.0, processor->presetMorphCurve);
+        } else if (actionID == MENU_OPTION_PRESET_MORPH_2_BEATS){
+            processor->setPresetMorph(2.0, processor->presetMorphCurve);
+        } else if (actionID == MENU_OPTION_PRESET_MORPH_4_BEATS){
+            processor->setPresetMorph(4.0, processor->presetMorphCurve);
+        } else if (actionID == MENU_OPTION_PRESET_MORPH_8_BEATS){
+            processor->setPresetMorph(8.0, processor->presetMorphCurve);
+        } else if (actionID == MENU_OPTION_PRESET_MORPH_EASE_ON){
+            processor->setPresetMorph(processor->presetMorphBeats, DDRMMorphCurve::easeInOut);
+        } else if (actionID == MENU_OPTION_PRESET_MORPH_EASE_OFF){
+            processor->setPresetMorph(processor->presetMorphBeats, DDRMMorphCurve::linear);
+        } else if (actionID == MENU_OPTION_TIMBRE_SPACE_RASTER_ON){
+            processor->timbreSpaceEngine->setInterpolationRasterEnabled(true);
+        } else if (actionID == MENU_OPTION_TIMBRE_SPACE_RASTER_OFF){
+            processor->timbreSpaceEngine->setInterpolationRasterEnabled(false);
+        } else if (actionID == MENU_OPTION_TIMBRE_SPACE_SNAP_ON){
+            processor->timbreSpaceEngine->setSnapToNearestPreset(true);
+        } else if (actionID == MENU_OPTION_TIMBRE_SPACE_SNAP_OFF){
+            processor->timbreSpaceEngine->setSnapToNearestPreset(false);
         }
     }
     
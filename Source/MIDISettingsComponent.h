@@ -15,7 +15,7 @@
 #include "defines.h"
 
 class MIDISettingsComponent: public Component,
-                             public ActionListener,
+                             public DDRMEventListener,
                              public Timer
 {
 public:
@@ -30,7 +30,7 @@ public:
     
     ~MIDISettingsComponent ()
     {
-        processor->removeActionListener(this);  // Stop receivng messages from processor
+        processor->removeEventListener(this);  // Stop receivng events from processor
         if (isTimerRunning()){
             stopTimer();
         }
@@ -42,7 +42,11 @@ public:
         processor = p;
         
         // Set up listeners
-        processor->addActionListener(this);  // Receive messages from processor
+        processor->addEventListener(this, {DDRMEvent::updatedMidiDeviceSettings,
+                                           DDRMEvent::refreshMidiDeviceLists,
+                                           DDRMEvent::midiEnableAutoScan,
+                                           DDRMEvent::midiDisableAutoScan,
+                                           DDRMEvent::midiTriggerDeviceScan});  // Receive events from processor
         
         // Build UI objects
         buildMidiChannelLists();
@@ -71,27 +75,27 @@ public:
         midiOutputChannelList.setBounds (2 * deviceSelectorWidth + channelSelectorWidth + 3 * unitMargin + inOutSeparator, 0, channelSelectorWidth, getHeight());
     }
     
-    void actionListenerCallback (const String &message) override
+    void ddrmEventCallback (DDRMEvent event) override
     {
-        if (message.startsWith(String(ACTION_UPDATED_MIDI_DEVICE_SETTINGS)))
+        if (event == DDRMEvent::updatedMidiDeviceSettings)
         {
             updateSelectedMidiDevices();
         }
-        else if (message.startsWith(String(ACTION_REFRESH_MIDI_DEVICE_LISTS)))
+        else if (event == DDRMEvent::refreshMidiDeviceLists)
         {
             refreshMidiInputOutputLists();
         }
-        else if (message.startsWith(String(ACTION_MIDI_ENABLE_AUTO_SCAN)))
+        else if (event == DDRMEvent::midiEnableAutoScan)
         {
             if (REFRESH_MIDI_DEVICES_TIMER_INTERVAL_MS > 0){
                 startTimer(REFRESH_MIDI_DEVICES_TIMER_INTERVAL_MS);
             }
         }
-        else if (message.startsWith(String(ACTION_MIDI_DISABLE_AUTO_SCAN)))
+        else if (event == DDRMEvent::midiDisableAutoScan)
         {
             stopTimer();
         }
-        else if (message.startsWith(String(ACTION_MIDI_TRIGGER_DEVICE_SCAN)))
+        else if (event == DDRMEvent::midiTriggerDeviceScan)
         {
             refreshMidiInputOutputLists();
         }
@@ -174,11 +178,13 @@ public:
             }
         }
         
-        if (processor->midiOutput != nullptr){
+        midiOutputList.setEnabled(!processor->midiTransmitter->isHostOutputEnabled());  // Host owns MIDI output in host output mode
+        if (processor->midiTransmitter->hasOutputDevice()){
             // Find and select the item in the combo box corresponding to the selected device (by name)
             int itemIdx = 0;
+            String midiOutputName = processor->midiTransmitter->getOutputDeviceName();
             for (int i=0; i<midiOutputList.getNumItems(); i++){
-                if (processor->midiOutput->getName() == midiOutputList.getItemText(i)){
+                if (midiOutputName == midiOutputList.getItemText(i)){
                     itemIdx = i;
                 }
             }
@@ -64,7 +64,8 @@ DdrmtimbreSpaceAudioProcessorEditor::DdrmtimbreSpaceAudioProcessorEditor (Ddrmti
     }
     
     // Register editor as an ActionListener for actions comming from the processor
-    processor.addActionListener(this);  // Receive messages from processor
+    processor.addActionListener(this);  // Receive log messages from processor
+    processor.addEventListener(this, {DDRMEvent::updateUIScaleFactor});  // Receive events from processor
     
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -78,6 +79,7 @@ DdrmtimbreSpaceAudioProcessorEditor::~DdrmtimbreSpaceAudioProcessorEditor()
 {
     setLookAndFeel (nullptr);
     processor.removeActionListener(this);
+    processor.removeEventListener(this);
 }
 
 //==============================================================================
@@ -157,7 +159,12 @@ void DdrmtimbreSpaceAudioProcessorEditor::actionListenerCallback (const String &
 {
     if (message.startsWith(String(ACTION_LOG_PREFIX))){
         logMessageInUI(message.substring(String(ACTION_LOG_PREFIX).length()));
-    } else if (message.startsWith(String(ACTION_UPDATE_UI_SCALE_FACTOR))){
+    }
+}
+
+void DdrmtimbreSpaceAudioProcessorEditor::ddrmEventCallback (DDRMEvent event)
+{
+    if (event == DDRMEvent::updateUIScaleFactor){
         resized();  // No need to update any local member here as scale factor is stored in processor
     }
 }
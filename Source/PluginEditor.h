@@ -28,7 +28,8 @@
 /**
 */
 class DdrmtimbreSpaceAudioProcessorEditor  : public AudioProcessorEditor,
-                                             public ActionListener
+                                             public ActionListener,
+                                             public DDRMEventListener
 {
 public:
     DdrmtimbreSpaceAudioProcessorEditor (DdrmtimbreSpaceAudioProcessor&);
@@ -68,6 +69,9 @@ private:
     // Tone selector component
     DDRMToneSelectorComponent ddrmToneSelector;
     
+    // Events from processor
+    void ddrmEventCallback (DDRMEvent event) override;
+    
     // Logging code
     void actionListenerCallback (const String &message) override;
     void logMessageInUI (const String& message);
@@ -23,328 +23,7 @@ DdrmtimbreSpaceAudioProcessor::DdrmtimbreSpaceAudioProcessor()
                        .withOutput ("Output", AudioChannelSet::stereo(), true)
                      #endif
                        ),
-        parameters (*this, nullptr, Identifier (STATE_AUDIO_PARAMETERS_IDENTIFIER),
-            {
-                // Add all audio parameters to plugin
-                // --> Start auto-generated code A
-                std:: make_unique < AudioParameterFloat > ("DDRM_SPEED_VCO_1", // parameter ID
-                                                            "Ch I: PWM Speed", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_PWM_VCO_1", // parameter ID
-                                                            "Ch I: PWM Amount", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_PW_VCO_1", // parameter ID
-                                                            "Ch I: PW", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SQR_VCO_1", // parameter ID
-                                                            "Ch I: Square", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SAW_VCO_1", // parameter ID
-                                                            "Ch I: Sawtooth", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_NOISE_VCO_1", // parameter ID
-                                                            "Ch I: Noise", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_HPF_VCF_1", // parameter ID
-                                                            "Ch I: HPF", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_RESh_VCF_1", // parameter ID
-                                                            "Ch I: RESh", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_LPF_VCF_1", // parameter ID
-                                                            "Ch I: LPF", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_RESl_VCF_1", // parameter ID
-                                                            "Ch I: RESl", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_IL_VCF_1", // parameter ID
-                                                            "Ch I: VCF IL", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_AL_VCF_1", // parameter ID
-                                                            "Ch I: VCF AL", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_A_VCF_1", // parameter ID
-                                                            "Ch I: VCF A", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_D_VCF_1", // parameter ID
-                                                            "Ch I: VCF D", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_R_VCF_1", // parameter ID
-                                                            "Ch I: VCF R", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_VCF_VCA_1", // parameter ID
-                                                            "Ch I: VCF Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SINE__VCA_1", // parameter ID
-                                                            "Ch I: Sine Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_A_VCA_1", // parameter ID
-                                                            "Ch I: VCA A", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_D_VCA_1", // parameter ID
-                                                            "Ch I: VCA D", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_S_VCA_1", // parameter ID
-                                                            "Ch I: VCA S", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_R_VCA_1", // parameter ID
-                                                            "Ch I: VCA R", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_LEVEL_VCA_1", // parameter ID
-                                                            "Ch I: Channel Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_INIT_BR_TOUCH_1", // parameter ID
-                                                            "Ch I: Initial Brilliance", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_INIT_LEV_TOUCH_1", // parameter ID
-                                                            "Ch I: Initial Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_AT_BR_TOUCH_1", // parameter ID
-                                                            "Ch I: After Brilliance", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_AT_LEV_TOUCH_1", // parameter ID
-                                                            "Ch I: After Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SPEED_VCO_2", // parameter ID
-                                                            "Ch II: PWM Speed", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_PWM_VCO_2", // parameter ID
-                                                            "Ch II: PWM Amount", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_PW_VCO_2", // parameter ID
-                                                            "Ch II: PW", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SQR_VCO_2", // parameter ID
-                                                            "Ch II: Square", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SAW_VCO_2", // parameter ID
-                                                            "Ch II: Sawtooth", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_NOISE_VCO_2", // parameter ID
-                                                            "Ch II: Noise", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_HPF_VCF_2", // parameter ID
-                                                            "Ch II: HPF", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_RESh_VCF_2", // parameter ID
-                                                            "Ch II: RESh", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_LPF_VCF_2", // parameter ID
-                                                            "Ch II: LPF", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_RESl_VCF_2", // parameter ID
-                                                            "Ch II: RESl", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_IL_VCF_2", // parameter ID
-                                                            "Ch II: VCF IL", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_AL_VCF_2", // parameter ID
-                                                            "Ch II: VCF AL", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_A_VCF_2", // parameter ID
-                                                            "Ch II: VCF A", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_D_VCF_2", // parameter ID
-                                                            "Ch II: VCF D", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_R_VCF_2", // parameter ID
-                                                            "Ch II: VCF R", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_VCF_VCA_2", // parameter ID
-                                                            "Ch II: VCF Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SINE__VCA_2", // parameter ID
-                                                            "Ch II: Sine Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_A_VCA_2", // parameter ID
-                                                            "Ch II: VCA A", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_D_VCA_2", // parameter ID
-                                                            "Ch II: VCA D", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_S_VCA_2", // parameter ID
-                                                            "Ch II: VCA S", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_R_VCA_2", // parameter ID
-                                                            "Ch II: VCA R", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_LEVEL_VCA_2", // parameter ID
-                                                            "Ch II: Channel Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_INIT_BR_TOUCH_2", // parameter ID
-                                                            "Ch II: Initial Brilliance", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_INIT_LEV_TOUCH_2", // parameter ID
-                                                            "Ch II: Initial Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_AT_BR_TOUCH_2", // parameter ID
-                                                            "Ch II: After Brilliance", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_AT_LEV_TOUCH_2", // parameter ID
-                                                            "Ch II: After Level", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_COARSE_PITCH", // parameter ID
-                                                            "Pitch Coarse", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_FINE_PITCH", // parameter ID
-                                                            "Pitch Fine", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_DETUNE_CH2_PITCH", // parameter ID
-                                                            "Detune Ch II", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_FEET_1_FEET", // parameter ID
-                                                            "Feet I", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_FEET_2_FEET", // parameter ID
-                                                            "Feet II", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_FUNCTION_SUB_OSC", // parameter ID
-                                                            "Sub Osc Function", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SPEED_SUB_OSC", // parameter ID
-                                                            "Sub Osc Speed", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_VCO_SUB_OSC", // parameter ID
-                                                            "Sub Osc VCO Amount", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_VCF_SUB_OSC", // parameter ID
-                                                            "Sub Osc VCF Amount", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_VCA_SUB_OSC", // parameter ID
-                                                            "Sub Osc VCA Amount", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_MIX", // parameter ID
-                                                            "Mix", // parameter name
-                                                            NormalisableRange < float > (0.0f, 126.0f, 1.0f), // parameter range
-                                                            63.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_BRILL", // parameter ID
-                                                            "Brilliance", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_RESSO", // parameter ID
-                                                            "Ressonance", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_INITIAL_TOUCH", // parameter ID
-                                                            "Initial Pitch Bend", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SPEED_TOUCH", // parameter ID
-                                                            "Touch Response Sub Osc Speed", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_VCO_TOUCH", // parameter ID
-                                                            "Touch Response Sub Osc VCO Amount", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_VCF_TOUCH", // parameter ID
-                                                            "Touch Response Sub Osc VCF Amount", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_BR_LOW_KBRD", // parameter ID
-                                                            "Brilliance Low", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_BR_HIGH_KBRD", // parameter ID
-                                                            "Brilliance High", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_LEV_LOW_KBRD", // parameter ID
-                                                            "Level Low", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_LEV_HIGH_KBRD", // parameter ID
-                                                            "Level High", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_GLIDE_MODE_GLIDE", // parameter ID
-                                                            "Glide Mode", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_GLIDE_TIME_GLIDE", // parameter ID
-                                                            "Glide Time", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SUSTAIN_MODE", // parameter ID
-                                                            "Sustain Mode", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                std:: make_unique < AudioParameterFloat > ("DDRM_SUSTAIN_TIME", // parameter ID
-                                                            "Sustain Time", // parameter name
-                                                            NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                            64.0f),
-                // --> End auto-generated code A
-                std:: make_unique < AudioParameterFloat > (String(SPACE_X_PARAMETER_ID), // parameter ID
-                                                           String(SPACE_X_PARAMETER_NAME), // parameter name
-                                                           NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                           65.0f),
-                std:: make_unique < AudioParameterFloat > (String(SPACE_Y_PARAMETER_ID), // parameter ID
-                                                           String(SPACE_Y_PARAMETER_NAME), // parameter name
-                                                           NormalisableRange < float > (0.0f, 127.0f, 1.0f), // parameter range
-                                                           65.0f)
-            })
+        parameters (*this, nullptr, Identifier (STATE_AUDIO_PARAMETERS_IDENTIFIER), createParameterLayout())
 #endif
 {
     // Add listeners to TimbreSpace position parameters
@@ -352,93 +31,26 @@ DdrmtimbreSpaceAudioProcessor::DdrmtimbreSpaceAudioProcessor()
     parameters.addParameterListener (String(SPACE_Y_PARAMETER_ID), this);
     
     // Add listeners for each audio parameter
-    // --> Start auto-generated code B
-    parameters.addParameterListener ("DDRM_SPEED_VCO_1", this);
-    parameters.addParameterListener ("DDRM_PWM_VCO_1", this);
-    parameters.addParameterListener ("DDRM_PW_VCO_1", this);
-    parameters.addParameterListener ("DDRM_SQR_VCO_1", this);
-    parameters.addParameterListener ("DDRM_SAW_VCO_1", this);
-    parameters.addParameterListener ("DDRM_NOISE_VCO_1", this);
-    parameters.addParameterListener ("DDRM_HPF_VCF_1", this);
-    parameters.addParameterListener ("DDRM_RESh_VCF_1", this);
-    parameters.addParameterListener ("DDRM_LPF_VCF_1", this);
-    parameters.addParameterListener ("DDRM_RESl_VCF_1", this);
-    parameters.addParameterListener ("DDRM_IL_VCF_1", this);
-    parameters.addParameterListener ("DDRM_AL_VCF_1", this);
-    parameters.addParameterListener ("DDRM_A_VCF_1", this);
-    parameters.addParameterListener ("DDRM_D_VCF_1", this);
-    parameters.addParameterListener ("DDRM_R_VCF_1", this);
-    parameters.addParameterListener ("DDRM_VCF_VCA_1", this);
-    parameters.addParameterListener ("DDRM_SINE__VCA_1", this);
-    parameters.addParameterListener ("DDRM_A_VCA_1", this);
-    parameters.addParameterListener ("DDRM_D_VCA_1", this);
-    parameters.addParameterListener ("DDRM_S_VCA_1", this);
-    parameters.addParameterListener ("DDRM_R_VCA_1", this);
-    parameters.addParameterListener ("DDRM_LEVEL_VCA_1", this);
-    parameters.addParameterListener ("DDRM_INIT_BR_TOUCH_1", this);
-    parameters.addParameterListener ("DDRM_INIT_LEV_TOUCH_1", this);
-    parameters.addParameterListener ("DDRM_AT_BR_TOUCH_1", this);
-    parameters.addParameterListener ("DDRM_AT_LEV_TOUCH_1", this);
-    parameters.addParameterListener ("DDRM_SPEED_VCO_2", this);
-    parameters.addParameterListener ("DDRM_PWM_VCO_2", this);
-    parameters.addParameterListener ("DDRM_PW_VCO_2", this);
-    parameters.addParameterListener ("DDRM_SQR_VCO_2", this);
-    parameters.addParameterListener ("DDRM_SAW_VCO_2", this);
-    parameters.addParameterListener ("DDRM_NOISE_VCO_2", this);
-    parameters.addParameterListener ("DDRM_HPF_VCF_2", this);
-    parameters.addParameterListener ("DDRM_RESh_VCF_2", this);
-    parameters.addParameterListener ("DDRM_LPF_VCF_2", this);
-    parameters.addParameterListener ("DDRM_RESl_VCF_2", this);
-    parameters.addParameterListener ("DDRM_IL_VCF_2", this);
-    parameters.addParameterListener ("DDRM_AL_VCF_2", this);
-    parameters.addParameterListener ("DDRM_A_VCF_2", this);
-    parameters.addParameterListener ("DDRM_D_VCF_2", this);
-    parameters.addParameterListener ("DDRM_R_VCF_2", this);
-    parameters.addParameterListener ("DDRM_VCF_VCA_2", this);
-    parameters.addParameterListener ("DDRM_SINE__VCA_2", this);
-    parameters.addParameterListener ("DDRM_A_VCA_2", this);
-    parameters.addParameterListener ("DDRM_D_VCA_2", this);
-    parameters.addParameterListener ("DDRM_S_VCA_2", this);
-    parameters.addParameterListener ("DDRM_R_VCA_2", this);
-    parameters.addParameterListener ("DDRM_LEVEL_VCA_2", this);
-    parameters.addParameterListener ("DDRM_INIT_BR_TOUCH_2", this);
-    parameters.addParameterListener ("DDRM_INIT_LEV_TOUCH_2", this);
-    parameters.addParameterListener ("DDRM_AT_BR_TOUCH_2", this);
-    parameters.addParameterListener ("DDRM_AT_LEV_TOUCH_2", this);
-    parameters.addParameterListener ("DDRM_COARSE_PITCH", this);
-    parameters.addParameterListener ("DDRM_FINE_PITCH", this);
-    parameters.addParameterListener ("DDRM_DETUNE_CH2_PITCH", this);
-    parameters.addParameterListener ("DDRM_FEET_1_FEET", this);
-    parameters.addParameterListener ("DDRM_FEET_2_FEET", this);
-    parameters.addParameterListener ("DDRM_FUNCTION_SUB_OSC", this);
-    parameters.addParameterListener ("DDRM_SPEED_SUB_OSC", this);
-    parameters.addParameterListener ("DDRM_VCO_SUB_OSC", this);
-    parameters.addParameterListener ("DDRM_VCF_SUB_OSC", this);
-    parameters.addParameterListener ("DDRM_VCA_SUB_OSC", this);
-    parameters.addParameterListener ("DDRM_MIX", this);
-    parameters.addParameterListener ("DDRM_BRILL", this);
-    parameters.addParameterListener ("DDRM_RESSO", this);
-    parameters.addParameterListener ("DDRM_INITIAL_TOUCH", this);
-    parameters.addParameterListener ("DDRM_SPEED_TOUCH", this);
-    parameters.addParameterListener ("DDRM_VCO_TOUCH", this);
-    parameters.addParameterListener ("DDRM_VCF_TOUCH", this);
-    parameters.addParameterListener ("DDRM_BR_LOW_KBRD", this);
-    parameters.addParameterListener ("DDRM_BR_HIGH_KBRD", this);
-    parameters.addParameterListener ("DDRM_LEV_LOW_KBRD", this);
-    parameters.addParameterListener ("DDRM_LEV_HIGH_KBRD", this);
-    parameters.addParameterListener ("DDRM_GLIDE_MODE_GLIDE", this);
-    parameters.addParameterListener ("DDRM_GLIDE_TIME_GLIDE", this);
-    parameters.addParameterListener ("DDRM_SUSTAIN_MODE", this);
-    parameters.addParameterListener ("DDRM_SUSTAIN_TIME", this);
-    // --> End auto-generated code B
+    for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+        parameters.addParameterListener (ddrmSynthControlDescriptors[i].ID, this);
+    }
 
     // Configure MIDI input/output
     // No need to configure here as it will be configured when calling "setMidiInputDevice/setMidiOutputDevice"
-    midiOutput = MidiOutput::openDevice(-1);  // Will return nullptr
+    midiTransmitter = new DDRMMidiTransmitter();  // Starts with no output device
+    automationDecimator = new DDRMAutomationDecimator(midiTransmitter);
+    morphEngine = new DDRMMorphEngine(midiTransmitter);
+    morphEngine->onMorphFinished = [this] { commitMorphTargetValues(); };
     midiInput = MidiInput::openDevice(-1, this);  // Will return nullptr
     midiOutputChannel = 1;
     midiInputChannel = 1;
-    timestampsLastCCSent = {0};  // Init this array to all 0s
+    for (int i=0; i<midiInputLatestValues.size(); i++){
+        midiInputLatestValues[i] = 0;
+    }
+    for (int i=0; i<midiInputDirtyMask.size(); i++){
+        midiInputDirtyMask[i] = 0;
+    }
+    deferredSpacePosition = noPendingSpacePosition();
     
     // DDRM Interface
     currentPreset = -1;
@@ -451,35 +63,69 @@ DdrmtimbreSpaceAudioProcessor::DdrmtimbreSpaceAudioProcessor()
     // Register processor as action listener for several objects
     timbreSpaceEngine->addActionListener(this);  // Receive log messages from timbre space engine
     ddrmInterface->addActionListener(this);  // Receive log messages from ddrm interface
+    midiTransmitter->addActionListener(this);  // Receive log messages from MIDI transmitter
+    timbreSpaceEngine->addEventListener(this, {DDRMEvent::loadInterpolatedPreset,
+                                               DDRMEvent::timbreSpaceSolutionComputed,
+                                               DDRMEvent::timbreSpaceRasterBuilt});  // Load interpolated presets and computed solutions/rasters
     
     // Initialize SynthControlObjects
-    ddrmInterface->loadSynthControlObjects();
+    ddrmInterface->loadSynthControlObjects(&parameters);
     
     // Other
     lastUsedDirectoryForFileIO = File::getSpecialLocation (File::userHomeDirectory);
     
     // Trigger load default state in processor
     setDefaultState();
+    
+    // Start timer to apply parameter changes coming from automation and MIDI input in the message thread
+    startTimer(DEFERRED_PARAMETER_CHANGES_FLUSH_INTERVAL_MS);
 }
 
 DdrmtimbreSpaceAudioProcessor::~DdrmtimbreSpaceAudioProcessor()
 {
+    stopTimer();
+    
     if (midiInput.get() != nullptr){
         midiInput.get()->stop();
     }
     
     midiInput.reset();
-    midiOutput.reset();
 
     // De-register action listeners
     timbreSpaceEngine->removeActionListener(this);
     ddrmInterface->removeActionListener(this);
+    midiTransmitter->removeActionListener(this);
+    timbreSpaceEngine->removeEventListener(this);
     
     // Delete objects that we store with pointers
+    delete morphEngine;  // Morph engine and automation decimator must be deleted before the transmitter as they queue messages in it
+    delete automationDecimator;
+    delete midiTransmitter;  // Stops transmitter thread and closes MIDI output device
     delete timbreSpaceEngine;
     delete ddrmInterface;
 }
 
+AudioProcessorValueTreeState::ParameterLayout DdrmtimbreSpaceAudioProcessor::createParameterLayout()
+{
+    // Add all audio parameters to plugin (one per entry in the synth control descriptors table plus timbre space position)
+    std::vector<std::unique_ptr<AudioParameterFloat>> audioParameters;
+    for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+        audioParameters.push_back(std::make_unique<AudioParameterFloat>(String(ddrmSynthControlDescriptors[i].ID), // parameter ID
+                                                                        String(ddrmSynthControlDescriptors[i].name), // parameter name
+                                                                        NormalisableRange<float> (0.0f, 127.0f, 1.0f), // parameter range
+                                                                        64.0f));
+    }
+    audioParameters.push_back(std::make_unique<AudioParameterFloat>(String(SPACE_X_PARAMETER_ID), // parameter ID
+                                                                    String(SPACE_X_PARAMETER_NAME), // parameter name
+                                                                    NormalisableRange<float> (0.0f, 127.0f, 1.0f), // parameter range
+                                                                    65.0f));
+    audioParameters.push_back(std::make_unique<AudioParameterFloat>(String(SPACE_Y_PARAMETER_ID), // parameter ID
+                                                                    String(SPACE_Y_PARAMETER_NAME), // parameter name
+                                                                    NormalisableRange<float> (0.0f, 127.0f, 1.0f), // parameter range
+                                                                    65.0f));
+    return { audioParameters.begin(), audioParameters.end() };
+}
+
 //==============================================================================
 const String DdrmtimbreSpaceAudioProcessor::getName() const
 {
@@ -545,14 +191,16 @@ void DdrmtimbreSpaceAudioProcessor::changeProgramName (int index, const String&
 //==============================================================================
 void DdrmtimbreSpaceAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
+    // Preallocate buffer used to filter host MIDI messages in processBlock
+    hostMidiMessages.ensureSize(DEFAULT_HOST_MIDI_BUFFER_SIZE);
+    midiTransmitter->setAudioProcessingActive(true);
 }
 
 void DdrmtimbreSpaceAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    midiTransmitter->setAudioProcessingActive(false);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -581,8 +229,44 @@ bool DdrmtimbreSpaceAudioProcessor::isBusesLayoutSupported (const BusesLayout& l
 
 void DdrmtimbreSpaceAudioProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
 {
-    // Do nothing with AUDIO and MIDI buffers as MIDI is sent and received using MidiInput
-    // and MidiOutput objects and this plugin does not process any audio.
+    // This plugin does not process any audio. MIDI is received using a MidiInput object and sent either
+    // using a MidiOutput object (owned by the MIDI transmitter) or, in host output mode, through the
+    // host MIDI buffer.
+    // Note, pitch bend and aftertouch messages coming from the host are merged with the CCs sent to the
+    // synth (see DDRMMidiTransmitter), other host messages are discarded.
+    // Audio input is only analysed during sound latency calibration
+    levelChangeDetector.processBlock(buffer, getTotalNumInputChannels(), Time::getMillisecondCounterHiRes(), getSampleRate());
+    
+    // Host transport is used to sync preset morphs
+    AudioPlayHead* playHead = getPlayHead();
+    AudioPlayHead::CurrentPositionInfo positionInfo;
+    if ((playHead != nullptr) && playHead->getCurrentPosition(positionInfo)){
+        morphEngine->setHostTransport(positionInfo.isPlaying, positionInfo.ppqPosition, positionInfo.bpm);
+    }
+    
+    MidiBuffer::Iterator it (midiMessages);
+    MidiMessage message;
+    int samplePosition;
+    if (midiTransmitter->isHostOutputEnabled()){
+        hostMidiMessages.clear();
+        while (it.getNextEvent (message, samplePosition)){
+            if (DDRMMidiTransmitter::isMergeableHostMessage(message)){
+                message.setChannel(midiOutputChannel);
+                hostMidiMessages.addEvent(message, samplePosition);
+            }
+        }
+        midiMessages.swapWith(hostMidiMessages);
+        midiTransmitter->renderToMidiBuffer(midiMessages, buffer.getNumSamples(), getSampleRate());
+    } else {
+        double blockStartTime = Time::getMillisecondCounterHiRes();
+        double sampleRate = getSampleRate();
+        while (it.getNextEvent (message, samplePosition)){
+            if (DDRMMidiTransmitter::isMergeableHostMessage(message) && (sampleRate > 0.0)){
+                midiTransmitter->enqueueHostMessage(message, blockStartTime + 1000.0 * samplePosition / sampleRate);
+            }
+        }
+        midiMessages.clear();
+    }
 }
 
 //==============================================================================
@@ -622,14 +306,19 @@ void DdrmtimbreSpaceAudioProcessor::getStateInformation (MemoryBlock& destData)
     } else {
         state.setProperty(STATE_MIDI_INPUT_DEVICE_NAME, "-", nullptr);
     }
-    if (midiOutput.get() != nullptr) {
-        state.setProperty(STATE_MIDI_OUTPUT_DEVICE_NAME, midiOutput.get()->getName(), nullptr);
-    } else {
-        state.setProperty(STATE_MIDI_OUTPUT_DEVICE_NAME, "-", nullptr);
-    }
-    state.setProperty(STATE_MIDI_INPUT_CHANNEL, midiInputChannel, nullptr);
-    state.setProperty(STATE_MIDI_OUTPUT_CHANNEL, midiOutputChannel, nullptr);
+    state.setProperty(STATE_MIDI_OUTPUT_DEVICE_NAME, midiTransmitter->getOutputDeviceName(), nullptr);  // "-" if no device
+    state.setProperty(STATE_MIDI_INPUT_CHANNEL, midiInputChannel.load(), nullptr);
+    state.setProperty(STATE_MIDI_OUTPUT_CHANNEL, midiOutputChannel.load(), nullptr);
     state.setProperty(STATE_MIDI_AUTOSCAN_ENABLED, midiDevicesAutoScanEnabled, nullptr);
+    state.setProperty(STATE_MIDI_OUTPUT_LINK_RATE, midiTransmitter->getLinkRate(), nullptr);
+    state.setProperty(STATE_MIDI_OUTPUT_TO_HOST, midiTransmitter->isHostOutputEnabled(), nullptr);
+    state.setProperty(STATE_AUTOMATION_CONTROL_RATE, automationDecimator->getControlRate(), nullptr);
+    state.setProperty(STATE_AUTOMATION_SLEW_LIMIT, automationDecimator->getSlewLimit() > 0, nullptr);
+    
+    // Add preset morph settings to state
+    state.setProperty(STATE_PRESET_MORPH_BEATS, presetMorphBeats, nullptr);
+    state.setProperty(STATE_PRESET_MORPH_CURVE, (int)presetMorphCurve, nullptr);
+    state.appendChild(midiLinkCalibrations.createCopy(), nullptr);
     
     // Add UI scale factor to state
     state.setProperty(STATE_UI_SCALE_FACTOR, uiScaleFactor, nullptr);
@@ -702,6 +391,10 @@ void DdrmtimbreSpaceAudioProcessor::setStateFromXml (XmlElement* xmlState)
         setMidiInputDeviceByName(midiInputDeviceName);
     }
     
+    if (xmlState->hasAttribute (STATE_MIDI_OUTPUT_TO_HOST)){
+        setMidiOutputToHost(xmlState->getBoolAttribute(STATE_MIDI_OUTPUT_TO_HOST));
+    }
+    
     if (xmlState->hasAttribute (STATE_MIDI_OUTPUT_DEVICE_NAME)){
         String midiOutputDeviceName = xmlState->getStringAttribute(STATE_MIDI_OUTPUT_DEVICE_NAME);
         setMidiOutputDeviceByName(midiOutputDeviceName);
@@ -722,6 +415,29 @@ void DdrmtimbreSpaceAudioProcessor::setStateFromXml (XmlElement* xmlState)
         setMidiDevicesAutoScan(savedMidiAutoScanEnabled);
     }
     
+    if (xmlState->hasAttribute (STATE_MIDI_OUTPUT_LINK_RATE)){
+        int bytesPerSecond = xmlState->getStringAttribute(STATE_MIDI_OUTPUT_LINK_RATE).getIntValue();
+        setMidiOutputLinkRate(bytesPerSecond);
+    }
+    
+    if (xmlState->hasAttribute (STATE_AUTOMATION_CONTROL_RATE)){
+        setAutomationControlRate(xmlState->getIntAttribute(STATE_AUTOMATION_CONTROL_RATE));
+    }
+    
+    if (xmlState->hasAttribute (STATE_AUTOMATION_SLEW_LIMIT)){
+        setAutomationSlewLimitEnabled(xmlState->getBoolAttribute(STATE_AUTOMATION_SLEW_LIMIT));
+    }
+    
+    if (xmlState->hasAttribute (STATE_PRESET_MORPH_BEATS)){
+        setPresetMorph((float)xmlState->getDoubleAttribute(STATE_PRESET_MORPH_BEATS),
+                       (DDRMMorphCurve)xmlState->getIntAttribute(STATE_PRESET_MORPH_CURVE));
+    }
+    
+    if (xmlState->getChildByName (STATE_MIDI_LINK_CALIBRATIONS_IDENTIFIER) != nullptr){
+        midiLinkCalibrations = ValueTree::fromXml (*xmlState->getChildByName (STATE_MIDI_LINK_CALIBRATIONS_IDENTIFIER));
+        applyMidiLinkCalibrationForCurrentDevice();
+    }
+    
     // Load ui scale factor
     if (xmlState->hasAttribute (STATE_UI_SCALE_FACTOR)){
         float newUIScaleFactor = xmlState->getStringAttribute(STATE_UI_SCALE_FACTOR).getFloatValue();
@@ -731,21 +447,21 @@ void DdrmtimbreSpaceAudioProcessor::setStateFromXml (XmlElement* xmlState)
     // Preset loader
     if (xmlState->getChildByName (STATE_PRESET_BANK_IDENTIFIER) != nullptr){
         ddrmInterface->loadPresetBankState(ValueTree::fromXml (*xmlState->getChildByName (STATE_PRESET_BANK_IDENTIFIER)));
-        sendActionMessage(ACTION_BANK_FILE_LOADED);
+        postEvent(DDRMEvent::bankFileLoaded);
     }
     
     // Current preset IDX
     if (xmlState->hasAttribute (STATE_CURRENT_PRESET_IDX)){
         currentPreset = xmlState->getStringAttribute(STATE_CURRENT_PRESET_IDX).getIntValue();
-        sendActionMessage(ACTION_SET_CURRENT_PRESET_NAME);
+        postEvent(DDRMEvent::setCurrentPresetName);
     }
     
     if (xmlState->hasAttribute (STATE_CURRENT_PRESET_OUT_OF_SYNC)){
         currentPresetOutOfSyncWithSliders = xmlState->getStringAttribute(STATE_CURRENT_PRESET_OUT_OF_SYNC) == "1";
         if (currentPresetOutOfSyncWithSliders){
-            sendActionMessage(ACTION_SET_CURRENT_PRESET_NAME_OUT_OF_SYNC);
+            postEvent(DDRMEvent::setCurrentPresetNameOutOfSync);
         } else {
-            sendActionMessage(ACTION_SET_CURRENT_PRESET_NAME_IN_SYNC);
+            postEvent(DDRMEvent::setCurrentPresetNameInSync);
         }
     }
     
@@ -785,8 +501,9 @@ void DdrmtimbreSpaceAudioProcessor::setStateFromXml (XmlElement* xmlState)
     
     // Audio parameters (for control panel and X,Y position in space)
     if (xmlState->getChildByName (STATE_AUDIO_PARAMETERS_IDENTIFIER) != nullptr){
-        const ScopedValueSetter<bool> scopedInputFlag (isLoadingFromState, true);
+        const bool wasLoadingFromState = isLoadingFromState.exchange(true);
         parameters.replaceState (ValueTree::fromXml (*xmlState->getChildByName (STATE_AUDIO_PARAMETERS_IDENTIFIER)));
+        isLoadingFromState = wasLoadingFromState;
     }
 }
 
@@ -799,6 +516,24 @@ void DdrmtimbreSpaceAudioProcessor::parameterChanged (const String& parameterID,
         return;
     }
     
+    if (isCommittingParameterTransaction && (Thread::getCurrentThreadId() == parameterTransactionThreadId)){
+        // Parameter is being set as part of a transaction, side effects will be applied once for the
+        // whole transaction when it finishes (see commitParameterTransaction)
+        int controlIndex = ddrmInterface->getControlIndexForID(parameterID);
+        if (controlIndex > -1){
+            parameterTransactionChangedControls[controlIndex] = true;
+            parameterTransactionChangedValues[controlIndex] = newValue;
+            return;
+        }
+    }
+    
+    if (!MessageManager::existsAndIsCurrentThread()){
+        // Parameter changed from host automation (audio thread), use the real-time safe path which defers side
+        // effects to the message thread
+        recordParameterChangeFromRealtimeThread(parameterID, newValue);
+        return;
+    }
+    
     if (parameterID.startsWith(String(DDRM_PARAMETER_ID_PREFIX))) {
         // DDRM parameter, send MIDI message to hardware (unless parameter change is received from MIDI input meaning the changed already happened in hardware
         #if JUCE_DEBUG
@@ -807,41 +542,24 @@ void DdrmtimbreSpaceAudioProcessor::parameterChanged (const String& parameterID,
             }
         #endif
         
-        if ((midiOutput.get() != nullptr) && (!isReceivingFromMidiInput)){
-            int ccNumber = ddrmInterface->getCCNumberForParameterID(parameterID);
-            int ccValue = (int)newValue;
-            MidiMessage msg = MidiMessage::controllerEvent(midiOutputChannel, ccNumber, ccValue);
-            midiOutput.get()->sendMessageNow(msg);
-            timestampsLastCCSent[ccNumber] = Time::getCurrentTime().toMilliseconds(); // Store timestamp when the message was sent
-            
-            #if JUCE_DEBUG
-                if (LOG_INDIVIDUAL_PARAMETER_CHANGES == 1){
-                    logMessage(String::formatted("Sent MIDI CC: %i %i", ccNumber, ccValue));
-                }
-            #endif
+        int controlIndex = ddrmInterface->getControlIndexForID(parameterID);
+        if (controlIndex < 0){
+            return;
         }
         
-        if (!isChangingFromToneSelector){
-            // Mark tone selector toggle OFF
-            int channelNumber = ddrmInterface->getChannelNumberForParameterID(parameterID);
-            if (channelNumber == 1){
-                ddrmInterface->setSelectedToneSelectorToNone(1);
-                ddrmInterface->setToneSelectorComponentRow1ButtonsToNone();
-                
-            } else if (channelNumber == 2){
-                ddrmInterface->setSelectedToneSelectorToNone(2);
-                ddrmInterface->setToneSelectorComponentRow2ButtonsToNone();
-            }
-        }
+        DDRMSynthControl& synthControl = ddrmInterface->getDDRMSynthControlAtIndex(controlIndex);
         
-        if (!isChangingFromTimbreSpace){
-            timbreSpaceEngine->setSelectedPointOutOfSync();
+        if (!isReceivingFromMidiInput){
+            // Message is not sent here but queued in the MIDI transmitter which sends it from its own thread
+            int ccNumber = synthControl.getCCNumber();
+            int ccValue = (int)newValue;
+            midiTransmitter->enqueueControlChange(ccNumber, ccValue);
+            automationDecimator->setCurrentValue(controlIndex, ccValue);
         }
+        morphEngine->releaseControl(controlIndex);
         
-        if (!isChangingFromPresetLoader){
-            currentPresetOutOfSyncWithSliders = true;
-            sendActionMessage(ACTION_SET_CURRENT_PRESET_NAME_OUT_OF_SYNC);
-        }
+        int channelNumber = synthControl.getChannelNumber();
+        applySynthControlChangeSideEffects(channelNumber == 1, channelNumber == 2);
         
     }  else if ((parameterID == SPACE_X_PARAMETER_ID) || (parameterID == SPACE_Y_PARAMETER_ID)) { // SPACE X or SPACE Y
         // Don't change these parameters if loading from timbre space as it would trigger selection of new point
@@ -852,12 +570,13 @@ void DdrmtimbreSpaceAudioProcessor::parameterChanged (const String& parameterID,
                 logMessage("Parameter " + parameterID + String::formatted(" changed: %f", newValue));
             #endif
             
-            if ((parameterID == String(SPACE_X_PARAMETER_ID)) || (parameterID == String(SPACE_Y_PARAMETER_ID))) {
-                if (parameterID == String(SPACE_X_PARAMETER_ID)) {
-                    timbreSpaceEngine->selectPointInSpace(newValue / 127.0f, -1.0);  // This will in its turn tell the processor to load new preset
-                } else if (parameterID == String(SPACE_Y_PARAMETER_ID)) {
-                    timbreSpaceEngine->selectPointInSpace(-1.0,  1.0f - (newValue / 127.0f));  // This will in its turn tell the processor to load new preset
-                }
+            // X and Y usually change together (two separate callbacks). Store them as a pending position which is
+            // resolved once in flushDeferredParameterChanges (same as for changes from the audio thread) so the
+            // timbre space only interpolates and sends the resulting preset once per tick.
+            if (parameterID == String(SPACE_X_PARAMETER_ID)) {
+                setDeferredSpaceCoordinate(true, newValue / 127.0f);
+            } else {
+                setDeferredSpaceCoordinate(false, 1.0f - (newValue / 127.0f));
             }
         }
     } else {
@@ -867,6 +586,206 @@ void DdrmtimbreSpaceAudioProcessor::parameterChanged (const String& parameterID,
     }
 }
 
+void DdrmtimbreSpaceAudioProcessor::recordParameterChangeFromRealtimeThread (const String& parameterID, float newValue)
+{
+    // Called from parameterChanged when not in the message thread. This must be real-time safe: no memory allocation,
+    // no locks and no logging. Side effects are recorded in atomics and applied in flushDeferredParameterChanges.
+    DDRM_REALTIME_SECTION
+    
+    int controlIndex = ddrmInterface->getControlIndexForID(parameterID);
+    if (controlIndex > -1){
+        // Value is quantised and resampled to the MIDI control rate by the automation decimator (lock-free),
+        // which queues it in the MIDI transmitter. MIDI input is never applied from the real-time thread (see
+        // drainMidiInputValues) so isReceivingFromMidiInput is not checked here.
+        automationDecimator->setTargetValue(controlIndex, newValue);
+        morphEngine->releaseControl(controlIndex);
+        int channelNumber = ddrmSynthControlDescriptors[controlIndex].channelNumber;
+        if (channelNumber == 1){
+            deferredChannel1Changed = true;
+        } else if (channelNumber == 2){
+            deferredChannel2Changed = true;
+        }
+        deferredSynthControlsChanged = true;
+        
+    } else if (parameterID == SPACE_X_PARAMETER_ID){
+        // Parameters here arrive with the non-normalized range so we need to scale them
+        setDeferredSpaceCoordinate(true, newValue / 127.0f);
+    } else if (parameterID == SPACE_Y_PARAMETER_ID){
+        setDeferredSpaceCoordinate(false, 1.0f - (newValue / 127.0f));
+    }
+}
+
+uint64 DdrmtimbreSpaceAudioProcessor::noPendingSpacePosition ()
+{
+    // Packed position with both coordinates set to -1.0
+    float noValue = -1.0f;
+    uint32 noValueBits;
+    std::memcpy(&noValueBits, &noValue, sizeof(noValueBits));
+    return ((uint64)noValueBits << 32) | noValueBits;
+}
+
+void DdrmtimbreSpaceAudioProcessor::setDeferredSpaceCoordinate (bool isX, float value)
+{
+    // Updates one coordinate of the pending timbre space position (lock-free, any thread)
+    // X and Y are packed in a single atomic word (X in the high 32 bits) so that the message thread always
+    // takes both coordinates at once and never resolves an intermediate position. -1.0 = no pending change.
+    uint32 valueBits;
+    std::memcpy(&valueBits, &value, sizeof(valueBits));
+    uint64 position = deferredSpacePosition.load();
+    uint64 newPosition;
+    do {
+        if (isX){
+            newPosition = ((uint64)valueBits << 32) | (position & 0xffffffff);
+        } else {
+            newPosition = (position & ((uint64)0xffffffff << 32)) | valueBits;
+        }
+    } while (!deferredSpacePosition.compare_exchange_weak(position, newPosition));
+}
+
+void DdrmtimbreSpaceAudioProcessor::flushDeferredParameterChanges ()
+{
+    // Applies the side effects of the parameter changes recorded by recordParameterChangeFromRealtimeThread (message thread)
+    if (deferredSynthControlsChanged.exchange(false)){
+        bool channel1Changed = deferredChannel1Changed.exchange(false);
+        bool channel2Changed = deferredChannel2Changed.exchange(false);
+        applySynthControlChangeSideEffects(channel1Changed, channel2Changed);
+    }
+    
+    uint64 position = deferredSpacePosition.exchange(noPendingSpacePosition());
+    uint32 spaceXBits = (uint32)(position >> 32);
+    uint32 spaceYBits = (uint32)(position & 0xffffffff);
+    float spaceX, spaceY;
+    std::memcpy(&spaceX, &spaceXBits, sizeof(spaceX));
+    std::memcpy(&spaceY, &spaceYBits, sizeof(spaceY));
+    if ((spaceX != -1.0f) || (spaceY != -1.0f)){
+        #if JUCE_DEBUG
+            logMessage(String::formatted("Timbre space position changed from automation: %f, %f", spaceX, spaceY));
+        #endif
+        timbreSpaceEngine->selectPointInSpace(spaceX, spaceY);  // -1.0 keeps coordinate, this will in its turn tell the processor to load new preset
+    }
+}
+
+void DdrmtimbreSpaceAudioProcessor::drainMidiInputValues ()
+{
+    // Applies the latest value received for each dirty CC number to the corresponding parameter (message thread)
+    // All values are set in a single transaction and a single gesture so incoming MIDI bursts (e.g. when moving
+    // a slider in the DDRM) result in at most one parameter update per CC and per drain.
+    std::array<uint64, 2> dirtyMask;
+    bool anyDirty = false;
+    for (int i=0; i<dirtyMask.size(); i++){
+        dirtyMask[i] = midiInputDirtyMask[i].exchange(0);
+        anyDirty = anyDirty || (dirtyMask[i] != 0);
+    }
+    if (!anyDirty){
+        return;
+    }
+    
+    const bool wasReceivingFromMidiInput = isReceivingFromMidiInput.exchange(true);
+    std::array<RangedAudioParameter*, 128> gestureParameters;
+    int numGestureParameters = 0;
+    {
+        ParameterTransaction transaction (*this);
+        for (int ccNumber=0; ccNumber<128; ccNumber++){
+            if ((dirtyMask[ccNumber / 64] >> (ccNumber % 64)) & 1){
+                const CCDispatchEntry& entry = ddrmInterface->getCCDispatchEntry(ccNumber);
+                if (entry.parameter != nullptr){
+                    entry.parameter->beginChangeGesture();
+                    gestureParameters[numGestureParameters++] = entry.parameter;
+                    transaction.setControlValue(entry.controlIndex, (double)midiInputLatestValues[ccNumber] / 127.0);
+                }
+            }
+        }
+    }
+    for (int i=0; i<numGestureParameters; i++){
+        gestureParameters[i]->endChangeGesture();
+    }
+    isReceivingFromMidiInput = wasReceivingFromMidiInput;
+}
+
+void DdrmtimbreSpaceAudioProcessor::timerCallback ()
+{
+    drainMidiInputValues();
+    flushDeferredParameterChanges();
+}
+
+void DdrmtimbreSpaceAudioProcessor::applySynthControlChangeSideEffects (bool channel1Changed, bool channel2Changed)
+{
+    // Updates tone selector, timbre space and preset sync state after one or more synth controls changed
+    if (!isChangingFromToneSelector){
+        // Mark tone selector toggle OFF
+        if (channel1Changed){
+            ddrmInterface->setSelectedToneSelectorToNone(1);
+            ddrmInterface->setToneSelectorComponentRow1ButtonsToNone();
+        }
+        if (channel2Changed){
+            ddrmInterface->setSelectedToneSelectorToNone(2);
+            ddrmInterface->setToneSelectorComponentRow2ButtonsToNone();
+        }
+    }
+    
+    if (!isChangingFromTimbreSpace){
+        timbreSpaceEngine->setSelectedPointOutOfSync();
+    }
+    
+    if (!isChangingFromPresetLoader){
+        currentPresetOutOfSyncWithSliders = true;
+        postEvent(DDRMEvent::setCurrentPresetNameOutOfSync);
+    }
+}
+
+void DdrmtimbreSpaceAudioProcessor::commitParameterTransaction (const ParameterTransactionValues& values, const ParameterTransactionMask& valuesMask, const uint8* ccFrames)
+{
+    // Applies the values of a ParameterTransaction to the audio parameters and then applies the side effects
+    // of all the parameters that changed at once
+    // If ccFrames is given (CC frames for all synth controls), it is sent to the synth as a single batch
+    parameterTransactionChangedControls.reset();
+    {
+        // Thread id is set before the flag so the audio thread never sees the flag with a stale id
+        parameterTransactionThreadId = Thread::getCurrentThreadId();
+        const bool wasCommittingParameterTransaction = isCommittingParameterTransaction.exchange(true);
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            if (valuesMask[i]){
+                ddrmInterface->getParameterForControlIndex(i)->setValueNotifyingHost(values[i]);
+            }
+        }
+        isCommittingParameterTransaction = wasCommittingParameterTransaction;
+    }
+
+    if ((ccFrames != nullptr) && !isReceivingFromMidiInput){
+        // Controls equal to the transmitter shadow state are not sent
+        midiTransmitter->enqueueControlChangeFrames(ccFrames, DDRM_NUM_SYNTH_CONTROLS);
+    }
+    
+    if (parameterTransactionChangedControls.none()){
+        return;  // No parameter value changed
+    }
+    
+    // Send one MIDI batch with all changed controls
+    bool channel1Changed = false;
+    bool channel2Changed = false;
+    for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+        if (parameterTransactionChangedControls[i]){
+            DDRMSynthControl& synthControl = ddrmInterface->getDDRMSynthControlAtIndex(i);
+            if ((ccFrames == nullptr) && !isReceivingFromMidiInput){
+                midiTransmitter->enqueueControlChange(synthControl.getCCNumber(), (int)parameterTransactionChangedValues[i]);
+            }
+            automationDecimator->setCurrentValue(i, (int)parameterTransactionChangedValues[i]);
+            morphEngine->releaseControl(i);
+            channel1Changed = channel1Changed || (synthControl.getChannelNumber() == 1);
+            channel2Changed = channel2Changed || (synthControl.getChannelNumber() == 2);
+        }
+    }
+    
+    // Notify other components only once
+    applySynthControlChangeSideEffects(channel1Changed, channel2Changed);
+    
+    #if JUCE_DEBUG
+        if (LOG_INDIVIDUAL_PARAMETER_CHANGES == 1){
+            logMessage(String::formatted("Committed parameter transaction with %i changed controls", (int)parameterTransactionChangedControls.count()));
+        }
+    #endif
+}
+
 void DdrmtimbreSpaceAudioProcessor::updateSpacePointAudioParametersFromMouseEvent(float x, float y)
 {
     // x,y come in range [0.0, 1.0]
@@ -887,71 +806,74 @@ void DdrmtimbreSpaceAudioProcessor::setMidiDevicesAutoScan (bool enabled)
         midiDevicesAutoScanEnabled = enabled;
         if (midiDevicesAutoScanEnabled){
             // If it was just enabled, send action message that will enable timer in MIDISettingsComponent
-            sendActionMessage(ACTION_MIDI_ENABLE_AUTO_SCAN);
+            postEvent(DDRMEvent::midiEnableAutoScan);
         } else {
             // If it was just disabled, send action message that will disable timer in MIDISettingsComponent
-            sendActionMessage(ACTION_MIDI_DISABLE_AUTO_SCAN);
+            postEvent(DDRMEvent::midiDisableAutoScan);
         }
     };
 }
 
 void DdrmtimbreSpaceAudioProcessor::triggerMidiDevicesScan ()
 {
-    sendActionMessage(ACTION_MIDI_TRIGGER_DEVICE_SCAN);
+    postEvent(DDRMEvent::midiTriggerDeviceScan);
 }
 
 void DdrmtimbreSpaceAudioProcessor::handleIncomingMidiMessage(MidiInput* source, const MidiMessage& m)
 {
-    if ((midiInputChannel == -1) || (m.getChannel() == midiInputChannel))
+    int channel = midiInputChannel;
+    if ((channel == -1) || (m.getChannel() == channel))
     {
         if (m.isController())
         {
             int ccNumber = m.getControllerNumber();
             int ccValue = m.getControllerValue();
             
-            /* There is bug with MIDI implementation of SQR and SAW switches in DDRM.
-             The problem is that these controls react to MIDI CC 70 and 71 but send MIDI CC 71
-             and 70 (are inverted in MIDI in/out). The code below fixes this issue and should be
-             changed once this is fixed in DDRM firmware.
-             More details here: https://github.com/ffont/official-ddrm-issue-tracker/issues/39
+            /* Ignore MIDI input messages which are echoes of messages sent by this app. DDRM replicates
+             every MIDI message it receives and forwards it to its output, so if the message came from this
+             app we want to ignore the replica sent by DDRM.
+             
+             To implement that check, everytime the MIDI transmitter sends a MIDI CC message it records the
+             value and send time as an "expected echo" for that CC number. An incoming message is only
+             considered an echo if it matches the value of an expected echo within an adaptive time window
+             (see DDRMExpectedEchoTracker). Any other message is a genuine change made on the synth and is
+             applied immediately.
              
+             Echoes are replicas of the messages we sent, so this check is done with the CC number as
+             received (before applying the SQR/SAW CC number fix below).
              */
             
-            if (ccNumber == 70){
-                ccNumber = 71;
-            } else if (ccNumber == 71){
-                ccNumber = 70;
-            }
-            
-            /* Only process MIDI input message if a certain amount of time has passed since
-             last time a MIDI CC message was sent from this app to the same CC number. This
-             is to avoid a problem in DDRM which will replicate every MIDI message it receives
-             and forward it to its output. If the message came from this app we want to ignore the
-             replica sent by DDRM. The amount of time that should pass is defined in
-             MIDI_IN_SAME_CC_TIME_THRESHOLD_MS.
+            if (!midiTransmitter->consumeExpectedEcho(ccNumber, ccValue)){
+                /* There is bug with MIDI implementation of SQR and SAW switches in DDRM.
+                 The problem is that these controls react to MIDI CC 70 and 71 but send MIDI CC 71
+                 and 70 (are inverted in MIDI in/out). The code below fixes this issue and should be
+                 changed once this is fixed in DDRM firmware.
+                 More details here: https://github.com/ffont/official-ddrm-issue-tracker/issues/39
              
-             To implement that check, everytime we send a MIDI CC message we store a timestamp
-             in timestampsLastCCSent array. timestampsLastCCSent has 128 positions and each position
-             stores the timestamp for the last time a MIDI message was sent to the corresponding CC
-             value (per the position). E.g.: position 1 = MIDI CC #1.
-             */
+                 */
+            
+                if (ccNumber == 70){
+                    ccNumber = 71;
+                } else if (ccNumber == 71){
+                    ccNumber = 70;
+                }
             
-            int64 currentTime = Time::getCurrentTime().toMilliseconds();
-            int64 lastMessageSentToSameCCTime = timestampsLastCCSent[ccNumber];
-            if ((currentTime - lastMessageSentToSameCCTime) > MIDI_IN_SAME_CC_TIME_THRESHOLD_MS){
                 #if JUCE_DEBUG
                     if (LOG_MIDI_IN == 1){
                         logMessage("Received MIDI CC from " + source->getName() + String::formatted(": %i %i", ccNumber, ccValue));
                     }
                 #endif
                 
-                // Set parameter value from MIDI message
-                const ScopedValueSetter<bool> scopedInputFlag (isReceivingFromMidiInput, true);
-                float newValue = (float)ccValue/127.0;
-                const String parameterID = ddrmInterface->getParameterIDFromCCNumber(ccNumber);
-                parameters.getParameter(parameterID)->beginChangeGesture();
-                parameters.getParameter(parameterID)->setValueNotifyingHost(newValue);
-                parameters.getParameter(parameterID)->endChangeGesture();
+                // The synth now has that value, update the shadow state of the transmitter accordingly
+                midiTransmitter->updateShadowValueFromSynth(ccNumber, ccValue);
+                
+                // Store value in the latest values table, it will be set to the parameter from the message thread
+                // (see drainMidiInputValues). CCs not assigned to any synth control are ignored.
+                if (ddrmInterface->getCCDispatchEntry(ccNumber).parameter == nullptr){
+                    return;
+                }
+                midiInputLatestValues[ccNumber] = ccValue;
+                midiInputDirtyMask[ccNumber / 64].fetch_or((uint64)1 << (ccNumber % 64));
             }
         }
     }
@@ -971,22 +893,22 @@ void DdrmtimbreSpaceAudioProcessor::setMidiInputDevice (const String& deviceIden
         midiInput.reset();
         midiInput = MidiInput::openDevice(deviceIdentifier, this);
     }
-    sendActionMessage(ACTION_UPDATED_MIDI_DEVICE_SETTINGS);
+    postEvent(DDRMEvent::updatedMidiDeviceSettings);
     if (midiInput.get() != nullptr){
         midiInput.get()->start();
     }
+    applyMidiLinkCalibrationForCurrentDevice();
 }
 
 void DdrmtimbreSpaceAudioProcessor::setMidiOutputDevice (const String& deviceIdentifier)
 {
-    if (deviceIdentifier == "-"){
-        // If identifier is "-", disable midi output
-        midiOutput.reset();
-    } else {
-        midiOutput.reset();
-        midiOutput = MidiOutput::openDevice(deviceIdentifier);
+    // If identifier is "-", midi output will be disabled
+    if (midiTransmitter->isHostOutputEnabled()){
+        return;  // MIDI is sent through the host, no output device should be opened
     }
-    sendActionMessage(ACTION_UPDATED_MIDI_DEVICE_SETTINGS);
+    midiTransmitter->setOutputDevice(deviceIdentifier);
+    postEvent(DDRMEvent::updatedMidiDeviceSettings);
+    applyMidiLinkCalibrationForCurrentDevice();
 }
 
 void DdrmtimbreSpaceAudioProcessor::setMidiInputDeviceByName (const String& deviceName)
@@ -1021,7 +943,7 @@ void DdrmtimbreSpaceAudioProcessor::setMidiInputChannel (int channel)
         channel = 16;
     }
     midiInputChannel = channel;
-    sendActionMessage(ACTION_UPDATED_MIDI_DEVICE_SETTINGS);
+    postEvent(DDRMEvent::updatedMidiDeviceSettings);
 }
 
 void DdrmtimbreSpaceAudioProcessor::setMidiOutputChannel (int channel)
@@ -1032,7 +954,156 @@ void DdrmtimbreSpaceAudioProcessor::setMidiOutputChannel (int channel)
         channel = 16;
     }
     midiOutputChannel = channel;
-    sendActionMessage(ACTION_UPDATED_MIDI_DEVICE_SETTINGS);
+    midiTransmitter->setOutputChannel(channel);
+    postEvent(DDRMEvent::updatedMidiDeviceSettings);
+}
+
+void DdrmtimbreSpaceAudioProcessor::setMidiOutputToHost (bool enabled)
+{
+    // In host output mode CCs are written in the MIDI buffer of processBlock (and the MIDI output device is closed)
+    if (enabled && !producesMidi()){
+        return;
+    }
+    midiTransmitter->setHostOutputEnabled(enabled);
+    applyMidiLinkCalibrationForCurrentDevice();
+    postEvent(DDRMEvent::updatedMidiDeviceSettings);
+}
+
+void DdrmtimbreSpaceAudioProcessor::setMidiOutputLinkRate (int bytesPerSecond)
+{
+    #if JUCE_DEBUG
+        logMessage(String::formatted("MIDI transmitter stats: %i sent, %i coalesced, %i unchanged, %i dropped, %i ms max latency, %i echoes (%.1f ms round trip), %i lost, %i resent",
+                                     midiTransmitter->getNumSentMessages(), midiTransmitter->getNumCoalescedMessages(),
+                                     midiTransmitter->getNumUnchangedMessages(), midiTransmitter->getNumDroppedMessages(),
+                                     (int)midiTransmitter->getMaxQueueLatencyMs(), midiTransmitter->getNumConsumedEchoes(),
+                                     midiTransmitter->getEstimatedEchoLatencyMs(), midiTransmitter->getNumLostMessages(),
+                                     midiTransmitter->getNumResentMessages()));
+    #endif
+    midiTransmitter->setLinkRate(bytesPerSecond);
+    midiTransmitter->resetStats();
+    postEvent(DDRMEvent::updatedMidiDeviceSettings);
+}
+
+void DdrmtimbreSpaceAudioProcessor::setAutomationControlRate (int hz)
+{
+    #if JUCE_DEBUG
+        // Log how many host updates were absorbed per control so the control rate can be tuned
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            DDRMAutomationDecimator::Stats stats = automationDecimator->getStats(i);
+            if (stats.numReceived > 0){
+                logMessage("Automation stats for " + String(ddrmSynthControlDescriptors[i].ID)
+                           + String::formatted(": %i host updates, %i absorbed, %i sent", stats.numReceived,
+                                               stats.numDropped, stats.numSent));
+            }
+        }
+    #endif
+    automationDecimator->setControlRate(hz);
+    automationDecimator->resetStats();
+}
+
+void DdrmtimbreSpaceAudioProcessor::setAutomationSlewLimitEnabled (bool enabled)
+{
+    automationDecimator->setSlewLimit(enabled ? AUTOMATION_SLEW_LIMIT_STEPS : 0);
+}
+
+void DdrmtimbreSpaceAudioProcessor::calibrateMidiOutputLink ()
+{
+    // Measures the capacity of the link to the DDRM using its MIDI echoes (see DDRMMidiLinkCalibrator) and
+    // stores the result for the current MIDI output device
+    if (!midiTransmitter->hasOutputDevice() || (midiInput.get() == nullptr)){
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "MIDI link calibration",
+                                          "Both MIDI input and MIDI output devices connected to the DDRM need to be selected to calibrate the MIDI link.");
+        return;
+    }
+    
+    DDRMMidiLinkCalibrator calibrator (midiTransmitter, ddrmInterface);
+    calibrator.runThread();
+    if (!calibrator.succeeded){
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "MIDI link calibration", calibrator.errorMessage);
+        return;
+    }
+    
+    #if JUCE_DEBUG
+        logMessage(String::formatted("MIDI link calibrated: %i bytes per second, %.1f ms round trip", calibrator.calibratedBytesPerSecond, calibrator.measuredRoundTripMs));
+    #endif
+    ValueTree calibration = getMidiLinkCalibrationForCurrentDevice(true);
+    calibration.setProperty(STATE_MIDI_LINK_CALIBRATION_BYTES_PER_SECOND, calibrator.calibratedBytesPerSecond, nullptr);
+    calibration.setProperty(STATE_MIDI_LINK_CALIBRATION_ROUND_TRIP_MS, calibrator.measuredRoundTripMs, nullptr);
+    applyMidiLinkCalibrationForCurrentDevice();
+}
+
+bool DdrmtimbreSpaceAudioProcessor::hasMidiLinkCalibrationForCurrentDevice ()
+{
+    ValueTree calibration = getMidiLinkCalibrationForCurrentDevice(false);
+    return calibration.hasProperty(STATE_MIDI_LINK_CALIBRATION_BYTES_PER_SECOND);
+}
+
+void DdrmtimbreSpaceAudioProcessor::calibrateSoundLatency ()
+{
+    // Measures the time from sending a CC to the DDRM until the change of sound reaches the audio input of the
+    // plugin (see DDRMSoundLatencyCalibrator) and stores the result for the current MIDI output device.
+    // Known-future CC events (preset morphs) are then sent that amount of time in advance.
+    if (!midiTransmitter->hasOutputDevice() || (getTotalNumInputChannels() == 0)){
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "Sound latency calibration",
+                                          "A MIDI output device connected to the DDRM and the DDRM audio output connected to the plugin input are needed to calibrate the sound latency.");
+        return;
+    }
+    
+    DDRMSoundLatencyCalibrator calibrator (midiTransmitter, ddrmInterface, &levelChangeDetector);
+    calibrator.runThread();
+    sendControlsToSynth(-1);  // Restore channel levels changed during calibration
+    if (!calibrator.succeeded){
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "Sound latency calibration", calibrator.errorMessage);
+        return;
+    }
+    
+    #if JUCE_DEBUG
+        logMessage(String::formatted("Sound latency calibrated: %.1f ms", calibrator.measuredLatencyMs));
+    #endif
+    ValueTree calibration = getMidiLinkCalibrationForCurrentDevice(true);
+    calibration.setProperty(STATE_MIDI_LINK_CALIBRATION_SOUND_LATENCY_MS, calibrator.measuredLatencyMs, nullptr);
+    applyMidiLinkCalibrationForCurrentDevice();
+    AlertWindow::showMessageBoxAsync (AlertWindow::InfoIcon, "Sound latency calibration",
+                                      String::formatted("Measured sound latency: %.1f ms. Preset morphs will be sent this amount of time in advance.", calibrator.measuredLatencyMs));
+}
+
+float DdrmtimbreSpaceAudioProcessor::getSoundLatencyMsForCurrentDevice ()
+{
+    ValueTree calibration = getMidiLinkCalibrationForCurrentDevice(false);
+    return calibration.getProperty(STATE_MIDI_LINK_CALIBRATION_SOUND_LATENCY_MS, -1.0f);
+}
+
+ValueTree DdrmtimbreSpaceAudioProcessor::getMidiLinkCalibrationForCurrentDevice (bool create)
+{
+    // Calibration results of the current MIDI output device. If create is true and the device has not been
+    // calibrated yet, an empty calibration is added for it.
+    String deviceName = midiTransmitter->getOutputDeviceName();
+    ValueTree calibration = midiLinkCalibrations.getChildWithProperty(STATE_MIDI_LINK_CALIBRATION_DEVICE_NAME, deviceName);
+    if (!calibration.isValid() && create){
+        calibration = ValueTree(STATE_MIDI_LINK_CALIBRATION_IDENTIFIER);
+        calibration.setProperty(STATE_MIDI_LINK_CALIBRATION_DEVICE_NAME, deviceName, nullptr);
+        midiLinkCalibrations.appendChild(calibration, nullptr);
+    }
+    return calibration;
+}
+
+void DdrmtimbreSpaceAudioProcessor::applyMidiLinkCalibrationForCurrentDevice ()
+{
+    // If the current MIDI output device has been calibrated, use the calibrated link rate, round trip time and
+    // sound latency. Lost messages can only be detected (and resent) with a calibrated link and MIDI input connected
+    // to the synth.
+    ValueTree calibration = getMidiLinkCalibrationForCurrentDevice(false);
+    morphEngine->setLookaheadMs(jmax(0.0f, getSoundLatencyMsForCurrentDevice()));
+    if (!calibration.hasProperty(STATE_MIDI_LINK_CALIBRATION_BYTES_PER_SECOND)){
+        midiTransmitter->setEchoAcknowledgementEnabled(false);
+        return;
+    }
+    midiTransmitter->setEstimatedEchoLatencyMs((float)calibration.getProperty(STATE_MIDI_LINK_CALIBRATION_ROUND_TRIP_MS, MIDI_ECHO_INITIAL_LATENCY_ESTIMATE_MS));
+    int bytesPerSecond = calibration.getProperty(STATE_MIDI_LINK_CALIBRATION_BYTES_PER_SECOND, MIDI_LINK_RATE_DIN);
+    if (bytesPerSecond != midiTransmitter->getLinkRate()){
+        setMidiOutputLinkRate(bytesPerSecond);
+    }
+    midiTransmitter->setEchoAcknowledgementEnabled(midiInput.get() != nullptr);
 }
 
 //==============================================================================
@@ -1047,7 +1118,7 @@ void DdrmtimbreSpaceAudioProcessor::loadBankFile (File* bankFile)
     currentPreset = -1;
     currentPresetOutOfSyncWithSliders = true;
     ddrmInterface->loadPresetBankFromFile(filePath);
-    sendActionMessage(ACTION_BANK_FILE_LOADED);
+    postEvent(DDRMEvent::bankFileLoaded);
     loadPresetAtIndex(0);
 }
 
@@ -1057,10 +1128,10 @@ void DdrmtimbreSpaceAudioProcessor::computeTimbreSpace ()
         return;
     }
     
+    // Solution is computed in a background thread (cancelling any computation in progress) and loaded when
+    // the timbreSpaceSolutionComputed event is received
     timbreSpaceEngine->setIsLoadingSolutionInTimbreSpaceComponent();
-    timbreSpaceEngine->computeMapPoints(ddrmInterface->generateBankDataForTimbreSpaceEngine());
-    timbreSpaceEngine->computeTriangulation();
-    timbreSpaceEngine->loadSolutionDataInTimbreSpaceComponent();
+    timbreSpaceEngine->computeSolutionInBackground(ddrmInterface->generateBankDataForTimbreSpaceEngine());
 }
 
 
@@ -1070,7 +1141,7 @@ void DdrmtimbreSpaceAudioProcessor::nextPreset()
         return;
     }
     
-    loadPresetAtIndex(currentPreset + 1);
+    loadPresetAtIndex(currentPreset + 1, true);
 }
 
 void DdrmtimbreSpaceAudioProcessor::previousPreset()
@@ -1083,14 +1154,16 @@ void DdrmtimbreSpaceAudioProcessor::previousPreset()
         // If no selected preset, do nothing
     } else if (currentPreset - 1 < 0) {
         // Don't let set currentPreset to -1 using the "previous" button
-        loadPresetAtIndex(0);
+        loadPresetAtIndex(0, true);
     } else {
-        loadPresetAtIndex(currentPreset - 1);
+        loadPresetAtIndex(currentPreset - 1, true);
     }
 }
 
-void DdrmtimbreSpaceAudioProcessor::loadPresetAtIndex (int index)
+void DdrmtimbreSpaceAudioProcessor::loadPresetAtIndex (int index, bool allowMorph)
 {
+    // If allowMorph is set and preset morphing is enabled, the synth glides to the preset (see DDRMMorphEngine)
+    // and the parameters are set when the morph finishes. Otherwise the preset is loaded instantly.
     if (!ddrmInterface->hasPresetsDataLoaded()){
         return;
     }
@@ -1103,13 +1176,70 @@ void DdrmtimbreSpaceAudioProcessor::loadPresetAtIndex (int index)
     }
     currentPreset = index;
     if (currentPreset > -1){
-        SynthControlIdValuePairs idValuePairs = ddrmInterface->getSynthControlIdValuePairsForPresetAtIndex(index);
-        setParametersFromSynthControlIdValuePairs(idValuePairs);
+        if (allowMorph && (presetMorphBeats > 0.0)){
+            // Morph starts from the values the synth has (which differ from the parameters if a morph is already playing)
+            ParameterTransactionValues sourceNormValues;
+            for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+                int shadowValue = midiTransmitter->getShadowValue(ddrmSynthControlDescriptors[i].ccNumber);
+                if (shadowValue < 0){
+                    shadowValue = (int)((AudioParameterFloat*)ddrmInterface->getParameterForControlIndex(i))->get();
+                }
+                sourceNormValues[i] = shadowValue / 127.0f;
+            }
+            morphEngine->startMorph(sourceNormValues.data(), ddrmInterface->getSynthControlIndexValuePairsForPresetAtIndex(index),
+                                    presetMorphBeats, presetMorphCurve);
+            
+            // Parameters keep the old values until the morph finishes, the preset is set in sync in commitMorphTargetValues
+            morphTargetPreset = index;
+            currentPresetOutOfSyncWithSliders = true;
+            postEvent(DDRMEvent::setCurrentPresetName);
+            postEvent(DDRMEvent::setCurrentPresetNameOutOfSync);
+            return;
+        }
+        
+        // Use the pre-decoded values and CC frames of the preset bank cache
+        morphEngine->stopMorph();
+        ParameterTransaction transaction (*this);
+        transaction.setAllControlValues(ddrmInterface->getCachedNormValuesForPresetAtIndex(index),
+                                        ddrmInterface->getCachedCCFramesForPresetAtIndex(index));
         timbreSpaceEngine->setTimbreSpaceComponentXYToPresetNumber(index);
     }
+    morphTargetPreset = -1;
     currentPresetOutOfSyncWithSliders = false;
-    sendActionMessage(ACTION_SET_CURRENT_PRESET_NAME);
-    sendActionMessage(ACTION_SET_CURRENT_PRESET_NAME_IN_SYNC);
+    postEvent(DDRMEvent::setCurrentPresetName);
+    postEvent(DDRMEvent::setCurrentPresetNameInSync);
+}
+
+void DdrmtimbreSpaceAudioProcessor::setPresetMorph (float beats, DDRMMorphCurve curve)
+{
+    presetMorphBeats = jmax(0.0f, beats);
+    presetMorphCurve = curve;
+}
+
+void DdrmtimbreSpaceAudioProcessor::commitMorphTargetValues ()
+{
+    // Called in the message thread when a morph finishes. The synth already has the target values, set them
+    // to the parameters as well (controls changed by other means during the morph are left untouched).
+    #if JUCE_DEBUG
+        logMessage(String::formatted("Finished morph with %i trajectory events", morphEngine->getNumTrajectoryEvents()));
+    #endif
+    const ScopedValueSetter<bool> scopedInputFlag (isChangingFromPresetLoader, true);
+    {
+        ParameterTransaction transaction (*this);
+        for (int i=0; i<DDRM_NUM_SYNTH_CONTROLS; i++){
+            if (morphEngine->isControlMorphed(i)){
+                transaction.setControlValue(i, morphEngine->getTargetNormValue(i));
+            }
+        }
+    }
+    
+    // The preset is only in sync if it is still the current one and no control was changed during the morph
+    if ((morphTargetPreset > -1) && (morphTargetPreset == currentPreset) && !morphEngine->hasReleasedControls()){
+        timbreSpaceEngine->setTimbreSpaceComponentXYToPresetNumber(currentPreset);
+        currentPresetOutOfSyncWithSliders = false;
+        postEvent(DDRMEvent::setCurrentPresetNameInSync);
+    }
+    morphTargetPreset = -1;
 }
 
 void DdrmtimbreSpaceAudioProcessor::savePresetToBankLocation (int bankLocation)
@@ -1122,18 +1252,18 @@ void DdrmtimbreSpaceAudioProcessor::savePresetToBankLocation (int bankLocation)
             bankLocation = ddrmInterface->getNumLoadedPresets() - 1;
         }
         
-        std::vector<String> parameterIDs = ddrmInterface->getDDRMSynthControlIDs();
+        const std::vector<int>& controlIndexes = ddrmInterface->getControlIndexes();
         DDRMPresetBytes currentPresetBytes = {0};  // Initialize to zero
-        for (int i=0; i<parameterIDs.size(); i++){
-            String parameterID = parameterIDs[i];
-            AudioParameterFloat* audioParameter = (AudioParameterFloat*)parameters.getParameter(parameterID);
-            DDRMSynthControl* synthControl = ddrmInterface->getDDRMSynthControlWithID(parameterID);
-            synthControl->updatePresetByteArray(audioParameter->get() / 127.0, currentPresetBytes);
+        for (int i=0; i<controlIndexes.size(); i++){
+            AudioParameterFloat* audioParameter = (AudioParameterFloat*)ddrmInterface->getParameterForControlIndex(controlIndexes[i]);
+            DDRMSynthControl& synthControl = ddrmInterface->getDDRMSynthControlAtIndex(controlIndexes[i]);
+            synthControl.updatePresetByteArray(audioParameter->get() / 127.0, currentPresetBytes);
         }
         ddrmInterface->saveCurrentPresetAtBankIndex(bankLocation, currentPresetBytes);
         currentPreset = bankLocation;
-        sendActionMessage(ACTION_SET_CURRENT_PRESET_NAME_IN_SYNC);
-        sendActionMessage(ACTION_CURRENT_PRESENT_SAVED_TO_BANK);
+        morphTargetPreset = -1;  // A running morph no longer leads to this preset
+        postEvent(DDRMEvent::setCurrentPresetNameInSync);
+        postEvent(DDRMEvent::currentPresetSavedToBank);
     }
 }
 
@@ -1157,17 +1287,15 @@ void DdrmtimbreSpaceAudioProcessor::saveBankFile ()
 void DdrmtimbreSpaceAudioProcessor::loadToneSelectorPreset (const String& toneSelectorPresetName, int ddrmChannel)
 {
     const ScopedValueSetter<bool> scopedInputFlag (isChangingFromToneSelector, true);
-    SynthControlIdValuePairs idValuePairs = ddrmInterface->getSynthControlIdValuePairsForToneSelectorPreset(toneSelectorPresetName, ddrmChannel);
-    setParametersFromSynthControlIdValuePairs(idValuePairs);
+    SynthControlIndexValuePairs indexValuePairs = ddrmInterface->getSynthControlIndexValuePairsForToneSelectorPreset(toneSelectorPresetName, ddrmChannel);
+    setParametersFromSynthControlIndexValuePairs(indexValuePairs);
 }
 
-void DdrmtimbreSpaceAudioProcessor::setParametersFromSynthControlIdValuePairs (SynthControlIdValuePairs idValuePairs)
+void DdrmtimbreSpaceAudioProcessor::setParametersFromSynthControlIndexValuePairs (const SynthControlIndexValuePairs& indexValuePairs)
 {
-    for (int i=0; i<idValuePairs.size(); i++) {
-        String parameterID = idValuePairs[i].first;
-        double newValue = idValuePairs[i].second;
-        parameters.getParameter(parameterID)->setValueNotifyingHost(newValue);
-    }
+    // Values are applied in a single transaction so side effects are only triggered once
+    ParameterTransaction transaction (*this);
+    transaction.setControlValues(indexValuePairs);
 }
 
 //==============================================================================
@@ -1176,62 +1304,49 @@ void DdrmtimbreSpaceAudioProcessor::setParametersFromSynthControlIdValuePairs (S
 
 void DdrmtimbreSpaceAudioProcessor::copyDDRMChannel1ToChannel2 ()
 {
-    SynthControlIdValuePairs idValuePairs = ddrmInterface->getSynthControlIdValuePairsForCopyingChannelFromToChannelTo(&parameters, 1, 2);
-    setParametersFromSynthControlIdValuePairs(idValuePairs);
+    SynthControlIndexValuePairs indexValuePairs = ddrmInterface->getSynthControlIndexValuePairsForCopyingChannelFromToChannelTo(1, 2);
+    setParametersFromSynthControlIndexValuePairs(indexValuePairs);
 }
 
 void DdrmtimbreSpaceAudioProcessor::copyDDRMChannel2ToChannel1 ()
 {
-    SynthControlIdValuePairs idValuePairs = ddrmInterface->getSynthControlIdValuePairsForCopyingChannelFromToChannelTo(&parameters, 2, 1);
-    setParametersFromSynthControlIdValuePairs(idValuePairs);
+    SynthControlIndexValuePairs indexValuePairs = ddrmInterface->getSynthControlIndexValuePairsForCopyingChannelFromToChannelTo(2, 1);
+    setParametersFromSynthControlIndexValuePairs(indexValuePairs);
 }
 
 void DdrmtimbreSpaceAudioProcessor::swapDDRMChannels ()
 {
-    SynthControlIdValuePairs idValuePairs1to2 = ddrmInterface->getSynthControlIdValuePairsForCopyingChannelFromToChannelTo(&parameters, 1, 2);
-    SynthControlIdValuePairs idValuePairs2to1 = ddrmInterface->getSynthControlIdValuePairsForCopyingChannelFromToChannelTo(&parameters, 2, 1);
-    setParametersFromSynthControlIdValuePairs(idValuePairs1to2);
-    setParametersFromSynthControlIdValuePairs(idValuePairs2to1);
+    SynthControlIndexValuePairs indexValuePairs1to2 = ddrmInterface->getSynthControlIndexValuePairsForCopyingChannelFromToChannelTo(1, 2);
+    SynthControlIndexValuePairs indexValuePairs2to1 = ddrmInterface->getSynthControlIndexValuePairsForCopyingChannelFromToChannelTo(2, 1);
+    ParameterTransaction transaction (*this);
+    transaction.setControlValues(indexValuePairs1to2);
+    transaction.setControlValues(indexValuePairs2to1);
 }
 
-void DdrmtimbreSpaceAudioProcessor::sendControlsToSynth (int channelFilter)
+void DdrmtimbreSpaceAudioProcessor::sendControlsToSynth (int channelFilter, bool forceFullResync)
 {
-    if (midiOutput.get() != nullptr) {
-        std::vector<String> parameterIDs;
-        if ((channelFilter == 1) || (channelFilter == 2)){
-            parameterIDs = ddrmInterface->getDDRMSynthControlIDsForChannel(channelFilter);
-        } else {
-            parameterIDs = ddrmInterface->getDDRMSynthControlIDs();
-        }
-        for (int i=0; i<parameterIDs.size(); i++){
-            String parameterID = parameterIDs[i];
-            int ccNumber = ddrmInterface->getCCNumberForParameterID(parameterID);
-            AudioParameterFloat* audioParameter = (AudioParameterFloat*)parameters.getParameter(parameterID);
+    // Sends the current value of all controls (or the controls of a given channel) to the synth
+    // Unless forceFullResync is set, only controls whose value differs from the transmitter shadow state are sent
+    if (midiTransmitter->hasDestination()) {
+        bool hasChannelFilter = (channelFilter == 1) || (channelFilter == 2);
+        const std::vector<int>& controlIndexes = hasChannelFilter ? ddrmInterface->getControlIndexesForChannel(channelFilter) : ddrmInterface->getControlIndexes();
+        for (int i=0; i<controlIndexes.size(); i++){
+            int ccNumber = ddrmInterface->getDDRMSynthControlAtIndex(controlIndexes[i]).getCCNumber();
+            AudioParameterFloat* audioParameter = (AudioParameterFloat*)ddrmInterface->getParameterForControlIndex(controlIndexes[i]);
             int ccValue = (int)audioParameter->get();  // Needs 0-127 int number for midi out
-            MidiMessage msg = MidiMessage::controllerEvent(midiOutputChannel, ccNumber, ccValue);
-            midiOutput.get()->sendMessageNow(msg);
-            timestampsLastCCSent[ccNumber] = Time::getCurrentTime().toMilliseconds(); // Store timestamp when the message was sent
-            #if JUCE_DEBUG
-                if (LOG_INDIVIDUAL_PARAMETER_CHANGES == 1){
-                    logMessage(String::formatted("Sent MIDI CC: %i %i", ccNumber, ccValue));
-                }
-            #endif
+            midiTransmitter->enqueueControlChange(ccNumber, ccValue, forceFullResync);
         }
     }
 }
 
 void DdrmtimbreSpaceAudioProcessor::randomizeControlValues (int channelFilter, float amount)
 {
-    std::vector<String> parameterIDs;
-    if ((channelFilter == 1) || (channelFilter == 2)){
-        parameterIDs = ddrmInterface->getDDRMSynthControlIDsForChannel(channelFilter);
-    } else {
-        parameterIDs = ddrmInterface->getDDRMSynthControlIDs();
-    }
+    bool hasChannelFilter = (channelFilter == 1) || (channelFilter == 2);
+    const std::vector<int>& controlIndexes = hasChannelFilter ? ddrmInterface->getControlIndexesForChannel(channelFilter) : ddrmInterface->getControlIndexes();
     Random* random = new Random();
-    for (int i=0; i<parameterIDs.size(); i++){
-        String parameterID = parameterIDs[i];
-        AudioParameterFloat* audioParameter = (AudioParameterFloat*)parameters.getParameter(parameterID);
+    ParameterTransaction transaction (*this);
+    for (int i=0; i<controlIndexes.size(); i++){
+        AudioParameterFloat* audioParameter = (AudioParameterFloat*)ddrmInterface->getParameterForControlIndex(controlIndexes[i]);
         float newValue;
         if (amount < 1.0){
             float randomValue = (random->nextFloat() - 0.5 ) * 2.0 * amount;
@@ -1240,7 +1355,7 @@ void DdrmtimbreSpaceAudioProcessor::randomizeControlValues (int channelFilter, f
         } else {
             newValue = random->nextFloat();
         }
-        audioParameter->setValueNotifyingHost(newValue); // parameter needs to be set in normalized range
+        transaction.setControlValue(controlIndexes[i], newValue); // parameter needs to be set in normalized range
     }
 }
 
@@ -1254,8 +1369,8 @@ void DdrmtimbreSpaceAudioProcessor::importFromPatchFile ()
         File file (fileChooser.getResult());
         setLastUserDirectoryForFileSaveLoad(file);
         String filePath = file.getFullPathName();
-        SynthControlIdValuePairs idValuePairs = ddrmInterface->getSynthControlIdValuePairsFromPatchFile(filePath);
-        setParametersFromSynthControlIdValuePairs(idValuePairs);
+        SynthControlIndexValuePairs indexValuePairs = ddrmInterface->getSynthControlIndexValuePairsFromPatchFile(filePath);
+        setParametersFromSynthControlIndexValuePairs(indexValuePairs);
     }
 }
 
@@ -1269,8 +1384,8 @@ void DdrmtimbreSpaceAudioProcessor::importFromVoiceFile (int channelTo)
         File file (fileChooser.getResult());
         setLastUserDirectoryForFileSaveLoad(file);
         String filePath = file.getFullPathName();
-        SynthControlIdValuePairs idValuePairs = ddrmInterface->getSynthControlIdValuePairsForChannelFromVoiceFile(filePath, channelTo);
-        setParametersFromSynthControlIdValuePairs(idValuePairs);
+        SynthControlIndexValuePairs indexValuePairs = ddrmInterface->getSynthControlIndexValuePairsForChannelFromVoiceFile(filePath, channelTo);
+        setParametersFromSynthControlIndexValuePairs(indexValuePairs);
     }
 }
 
@@ -1283,13 +1398,12 @@ void DdrmtimbreSpaceAudioProcessor::saveToPatchFile ()
     {
         File file (fileChooser.getResult());
         setLastUserDirectoryForFileSaveLoad(file);
-        std::vector<String> parameterIDs = ddrmInterface->getDDRMSynthControlIDs();
+        const std::vector<int>& controlIndexes = ddrmInterface->getControlIndexes();
         DDRMPresetBytes currentPresetBytes = {0};  // Initialize to zero
-        for (int i=0; i<parameterIDs.size(); i++){
-            String parameterID = parameterIDs[i];
-            AudioParameterFloat* audioParameter = (AudioParameterFloat*)parameters.getParameter(parameterID);
-            DDRMSynthControl* synthControl = ddrmInterface->getDDRMSynthControlWithID(parameterID);
-            synthControl->updatePresetByteArray(audioParameter->get() / 127.0, currentPresetBytes);
+        for (int i=0; i<controlIndexes.size(); i++){
+            AudioParameterFloat* audioParameter = (AudioParameterFloat*)ddrmInterface->getParameterForControlIndex(controlIndexes[i]);
+            DDRMSynthControl& synthControl = ddrmInterface->getDDRMSynthControlAtIndex(controlIndexes[i]);
+            synthControl.updatePresetByteArray(audioParameter->get() / 127.0, currentPresetBytes);
         }
         file.replaceWithData(&currentPresetBytes, DDRM_PRESET_NUM_BYTES);
     }
@@ -1304,13 +1418,12 @@ void DdrmtimbreSpaceAudioProcessor::saveToVoiceFile (int channelFrom)
     {
         File file (fileChooser.getResult());
         setLastUserDirectoryForFileSaveLoad(file);
-        std::vector<String> parameterIDs = ddrmInterface->getDDRMSynthControlIDsForChannel(channelFrom);
+        const std::vector<int>& controlIndexes = ddrmInterface->getControlIndexesForChannel(channelFrom);
         DDRMVoiceBytes currentVoiceBytes = {0};  // Initialize to zero
-        for (int i=0; i<parameterIDs.size(); i++){
-            String parameterID = parameterIDs[i];
-            AudioParameterFloat* audioParameter = (AudioParameterFloat*)parameters.getParameter(parameterID);
-            DDRMSynthControl* synthControl = ddrmInterface->getDDRMSynthControlWithID(parameterID);
-            synthControl->updateVoiceByteArray(audioParameter->get() / 127.0, currentVoiceBytes);
+        for (int i=0; i<controlIndexes.size(); i++){
+            AudioParameterFloat* audioParameter = (AudioParameterFloat*)ddrmInterface->getParameterForControlIndex(controlIndexes[i]);
+            DDRMSynthControl& synthControl = ddrmInterface->getDDRMSynthControlAtIndex(controlIndexes[i]);
+            synthControl.updateVoiceByteArray(audioParameter->get() / 127.0, currentVoiceBytes);
         }
         file.replaceWithData(&currentVoiceBytes, DDRM_VOICE_NUM_BYTES);
     }
@@ -1344,18 +1457,31 @@ void DdrmtimbreSpaceAudioProcessor::logMessage (const String& message)
 
 void DdrmtimbreSpaceAudioProcessor::actionListenerCallback (const String &message)
 {
-    if (message.startsWith(String(ACTION_LOAD_INTERPOLATED_PRESET))){
-        const ScopedValueSetter<bool> scopedInputFlag (isChangingFromTimbreSpace, true);
-        setParametersFromSynthControlIdValuePairs(
-            ddrmInterface->getSynthControlIdValuePairsForInterpolatedPresets(timbreSpaceEngine->getSelectedPointInterpolationData())
-        );
-    } else if (message.startsWith(String(ACTION_LOG_PREFIX))){
+    if (message.startsWith(String(ACTION_LOG_PREFIX))){
         #if JUCE_DEBUG
             logMessage(message.substring(String(ACTION_LOG_PREFIX).length()));
         #endif
     }
 }
 
+void DdrmtimbreSpaceAudioProcessor::ddrmEventCallback (DDRMEvent event)
+{
+    if (event == DDRMEvent::loadInterpolatedPreset){
+        const ScopedValueSetter<bool> scopedInputFlag (isChangingFromTimbreSpace, true);
+        setParametersFromSynthControlIndexValuePairs(
+            ddrmInterface->getSynthControlIndexValuePairsForInterpolatedPresets(timbreSpaceEngine->getSelectedPointInterpolationData())
+        );
+    } else if (event == DDRMEvent::timbreSpaceSolutionComputed){
+        bool loaded = timbreSpaceEngine->loadComputedSolution();
+        timbreSpaceEngine->loadSolutionDataInTimbreSpaceComponent();  // Also clears the computing status if computation failed
+        if (loaded && (currentPreset > -1) && !currentPresetOutOfSyncWithSliders){
+            timbreSpaceEngine->setTimbreSpaceComponentXYToPresetNumber(currentPreset);
+        }
+    } else if (event == DDRMEvent::timbreSpaceRasterBuilt){
+        timbreSpaceEngine->loadBuiltRaster();
+    }
+}
+
 //==============================================================================
 
 File DdrmtimbreSpaceAudioProcessor::getDirectoryForFileSaveLoad ()
@@ -1370,7 +1496,7 @@ void DdrmtimbreSpaceAudioProcessor::setLastUserDirectoryForFileSaveLoad (File fi
 
 void DdrmtimbreSpaceAudioProcessor::setUIScaleFactor(float newUIScaleFactor){
     uiScaleFactor = newUIScaleFactor;
-    sendActionMessage(ACTION_UPDATE_UI_SCALE_FACTOR);
+    postEvent(DDRMEvent::updateUIScaleFactor);
 }
 
 
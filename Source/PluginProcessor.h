@@ -10,11 +10,23 @@
 
 #pragma once
 
+#include <atomic>
+#include <bitset>
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "defines.h"
+#include "DDRMEventBus.h"
+#include "DDRMRealtimeTripwire.h"
 #include "DDRMInterface.h"
+#include "DDRMMidiTransmitter.h"
+#include "DDRMMidiLinkCalibrator.h"
+#include "DDRMAutomationDecimator.h"
+#include "DDRMMorphEngine.h"
+#include "DDRMLevelChangeDetector.h"
+#include "DDRMSoundLatencyCalibrator.h"
 #include "TimbreSpaceEngine.h"
 
+typedef std::array<float, DDRM_NUM_SYNTH_CONTROLS> ParameterTransactionValues;
+typedef std::bitset<DDRM_NUM_SYNTH_CONTROLS> ParameterTransactionMask;
 
 //==============================================================================
 /**
@@ -23,7 +35,10 @@ class DdrmtimbreSpaceAudioProcessor  : public AudioProcessor,
                                        private AudioProcessorValueTreeState::Listener,
                                        public ActionBroadcaster,
                                        public ActionListener,
-                                       public MidiInputCallback
+                                       public DDRMEventBus,
+                                       public DDRMEventListener,
+                                       public MidiInputCallback,
+                                       private Timer
 {
 public:
     //==============================================================================
@@ -65,20 +80,21 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
     void setDefaultState ();
     void setStateFromXml (XmlElement* xmlState);
-    bool isLoadingFromState = false;
+    std::atomic<bool> isLoadingFromState { false };  // Read from the audio thread in parameterChanged
     bool needsToLoadDefaultState = true;
     
     // Parameters tree
     AudioProcessorValueTreeState parameters;
+    static AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
     // MIDI input/output
     bool midiDevicesAutoScanEnabled = true;
     void setMidiDevicesAutoScan (bool enabled);
     void triggerMidiDevicesScan ();
-    std::unique_ptr<MidiOutput> midiOutput;
+    DDRMMidiTransmitter* midiTransmitter;  // Owns the MIDI output device and sends CC messages from its own thread
     std::unique_ptr<MidiInput> midiInput;
-    int midiOutputChannel;  // Range 1-16
-    int midiInputChannel;  // Range 1-16
+    std::atomic<int> midiOutputChannel;  // Range 1-16 (read in processBlock)
+    std::atomic<int> midiInputChannel;  // Range 1-16 (read in the MIDI input thread)
     void handleIncomingMidiMessage(MidiInput* source,const MidiMessage& m) override;
     void setMidiInputDevice (const String& deviceIdentifier);
     void setMidiInputDeviceByName (const String& deviceName);
@@ -86,7 +102,21 @@ public:
     void setMidiOutputDeviceByName (const String& deviceName);
     void setMidiInputChannel (int channel);
     void setMidiOutputChannel (int channel);
-    bool isReceivingFromMidiInput = false;  // To distinguish when a parameter is changed from the onscren Slider or from MIDI input
+    void setMidiOutputLinkRate (int bytesPerSecond);
+    void setMidiOutputToHost (bool enabled);
+    
+    // Host automation
+    DDRMAutomationDecimator* automationDecimator;  // Resamples host automation to the MIDI control rate
+    void setAutomationControlRate (int hz);
+    void setAutomationSlewLimitEnabled (bool enabled);
+    MidiBuffer hostMidiMessages;  // Host MIDI messages merged with CCs in host output mode (only used in processBlock)
+    void calibrateMidiOutputLink ();
+    bool hasMidiLinkCalibrationForCurrentDevice ();
+    void calibrateSoundLatency ();
+    float getSoundLatencyMsForCurrentDevice ();  // -1 if not calibrated
+    DDRMLevelChangeDetector levelChangeDetector;  // Analyses the audio input during sound latency calibration
+    ValueTree midiLinkCalibrations = ValueTree(STATE_MIDI_LINK_CALIBRATIONS_IDENTIFIER);  // Calibration results per MIDI output device name
+    std::atomic<bool> isReceivingFromMidiInput { false };  // To distinguish when a parameter is changed from the onscren Slider or from MIDI input
     
     // UI Scale factor
     float uiScaleFactor = 1.0;
@@ -96,15 +126,23 @@ public:
     void loadBankFile (File* bankFile);
     int currentPreset;
     bool currentPresetOutOfSyncWithSliders;
+    int morphTargetPreset = -1;  // Preset the synth is morphing to, in sync once the morph finishes (-1 = none)
     void nextPreset();
     void previousPreset();
     void savePresetToBankLocation (int bankLocation);
     void saveBankFile ();
-    void loadPresetAtIndex (int index);
+    void loadPresetAtIndex (int index, bool allowMorph=false);
+    DDRMMorphEngine* morphEngine;  // Glides the synth to presets loaded by the user (see presetMorphBeats)
+    float presetMorphBeats = 0.0;  // 0 = presets are loaded instantly
+    DDRMMorphCurve presetMorphCurve = DDRMMorphCurve::linear;
+    void setPresetMorph (float beats, DDRMMorphCurve curve);
     void loadToneSelectorPreset (const String& toneSelectorPresetName, int ddrmChannel);
-    void setParametersFromSynthControlIdValuePairs (SynthControlIdValuePairs idValuePairs);
+    void setParametersFromSynthControlIndexValuePairs (const SynthControlIndexValuePairs& indexValuePairs);
     bool isChangingFromPresetLoader = false;
     
+    // Parameter transactions (see ParameterTransaction below)
+    void commitParameterTransaction (const ParameterTransactionValues& values, const ParameterTransactionMask& valuesMask, const uint8* ccFrames=nullptr);
+    
     // DDRM Interface
     DDRMInterface* ddrmInterface;
     bool isChangingFromToneSelector = false;  // To distinguish when a parameter is changed because a button in tone selector has been pressed
@@ -113,7 +151,7 @@ public:
     void copyDDRMChannel1ToChannel2 ();
     void copyDDRMChannel2ToChannel1 ();
     void swapDDRMChannels ();
-    void sendControlsToSynth (int channelFilter);
+    void sendControlsToSynth (int channelFilter, bool forceFullResync=false);
     void randomizeControlValues (int channelFilter, float amount);
     void importFromPatchFile ();
     void importFromVoiceFile (int channelTo);
@@ -129,16 +167,112 @@ public:
     // Logging code
     void logMessage (const String& message);
     
-    // Action listener
+    // Action listener (log messages)
     void actionListenerCallback (const String &message) override;
     
+    // Event listener
+    void ddrmEventCallback (DDRMEvent event) override;
+    
     // Other
     File getDirectoryForFileSaveLoad ();
     void setLastUserDirectoryForFileSaveLoad (File file);
     File lastUsedDirectoryForFileIO;
-    TimestampsLastCCSent timestampsLastCCSent;
 
-private:    
+private:
+    // Parameter changes from non-message threads (host automation in the audio thread, MIDI input thread)
+    // These are recorded in atomics without allocating or locking and their side effects applied later
+    // in the message thread (see recordParameterChangeFromRealtimeThread and flushDeferredParameterChanges)
+    void recordParameterChangeFromRealtimeThread (const String& parameterID, float newValue);
+    void flushDeferredParameterChanges ();
+    void timerCallback () override;
+    std::atomic<bool> deferredSynthControlsChanged { false };
+    std::atomic<bool> deferredChannel1Changed { false };
+    std::atomic<bool> deferredChannel2Changed { false };
+    std::atomic<uint64> deferredSpacePosition;  // Pending (x, y) timbre space position packed in one word (see setDeferredSpaceCoordinate)
+    void setDeferredSpaceCoordinate (bool isX, float value);
+    static uint64 noPendingSpacePosition ();
+    
+    // MIDI input handoff to the message thread
+    // The MIDI input thread only stores the latest value received for each CC number and marks it as dirty,
+    // the message thread applies the latest values to the parameters at display rate (see drainMidiInputValues)
+    void drainMidiInputValues ();
+    void applyMidiLinkCalibrationForCurrentDevice ();
+    ValueTree getMidiLinkCalibrationForCurrentDevice (bool create);  // Invalid ValueTree if not calibrated and create is false
+    std::array<std::atomic<int>, 128> midiInputLatestValues;
+    std::array<std::atomic<uint64>, 2> midiInputDirtyMask;  // One bit per CC number
+    
+    // Parameter transactions
+    std::atomic<bool> isCommittingParameterTransaction { false };  // Read from the audio thread in parameterChanged
+    std::atomic<Thread::ThreadID> parameterTransactionThreadId { nullptr };
+    ParameterTransactionMask parameterTransactionChangedControls;
+    ParameterTransactionValues parameterTransactionChangedValues;
+    void applySynthControlChangeSideEffects (bool channel1Changed, bool channel2Changed);
+    void commitMorphTargetValues ();
+    
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DdrmtimbreSpaceAudioProcessor)
 };
+
+//==============================================================================
+class ParameterTransaction
+{
+public:
+    /*
+     Scope used to set the values of many synth controls at once (e.g. when loading a preset). Values
+     are collected with setControlValue/setControlValues and applied to the audio parameters when the
+     transaction is committed (explicitly or when the scope ends). While applying the values, the
+     per-parameter side effects of DdrmtimbreSpaceAudioProcessor::parameterChanged (MIDI messages,
+     tone selector reset, timbre space and preset out of sync notifications) are suppressed, and
+     are emitted only once for the whole transaction: one MIDI batch with the controls that actually
+     changed and one notification per affected component.
+     */
+    
+    ParameterTransaction (DdrmtimbreSpaceAudioProcessor& p): processor (p)
+    {
+    }
+    
+    ~ParameterTransaction ()
+    {
+        commit();
+    }
+    
+    void setControlValue (int controlIndex, double normValue)
+    {
+        values[controlIndex] = (float)normValue;
+        valuesMask[controlIndex] = true;
+    }
+    
+    void setControlValues (const SynthControlIndexValuePairs& indexValuePairs)
+    {
+        for (int i=0; i<indexValuePairs.size(); i++) {
+            setControlValue(indexValuePairs[i].first, indexValuePairs[i].second);
+        }
+    }
+    
+    void setAllControlValues (const float* normValues, const uint8* controlCCFrames)
+    {
+        // Sets the values of all synth controls at once (DDRM_NUM_SYNTH_CONTROLS values) from a pre-decoded
+        // preset (see DDRMPresetBank cache). The given CC frames are sent to the synth in one batch instead
+        // of encoding the changed controls one by one.
+        std::copy(normValues, normValues + DDRM_NUM_SYNTH_CONTROLS, values.begin());
+        valuesMask.set();
+        ccFrames = controlCCFrames;
+    }
+    
+    void commit ()
+    {
+        if (!committed){
+            committed = true;
+            processor.commitParameterTransaction(values, valuesMask, ccFrames);
+        }
+    }
+    
+private:
+    DdrmtimbreSpaceAudioProcessor& processor;
+    ParameterTransactionValues values;
+    ParameterTransactionMask valuesMask;
+    const uint8* ccFrames = nullptr;
+    bool committed = false;
+    
+    JUCE_DECLARE_NON_COPYABLE (ParameterTransaction)
+};
@@ -34,7 +34,7 @@ public:
 
 class PresetControlComponent: public Component,
                               public Button::Listener,
-                              public ActionListener
+                              public DDRMEventListener
 {
 public:
     
@@ -84,7 +84,7 @@ public:
     
     ~PresetControlComponent ()
     {
-        processor->removeActionListener(this);  // Stop receivng messages from processor
+        processor->removeEventListener(this);  // Stop receivng events from processor
     }
     
     void initialize (DdrmtimbreSpaceAudioProcessor* p)
@@ -93,7 +93,11 @@ public:
         processor = p;
         
         // Set up listeners
-        processor->addActionListener(this);  // Receive messages from processor
+        processor->addEventListener(this, {DDRMEvent::setCurrentPresetName,
+                                           DDRMEvent::setCurrentPresetNameOutOfSync,
+                                           DDRMEvent::setCurrentPresetNameInSync,
+                                           DDRMEvent::bankFileLoaded,
+                                           DDRMEvent::currentPresetSavedToBank});  // Receive events from processor
         
         // Set initial state of mmebers by getting data from processor
         setStateFromProcessor();
@@ -203,7 +207,7 @@ public:
         int presetIdx = presetNameLabel.getText().getIntValue() - 1;
         if (presetIdx > -1){
             // Valid number entered
-            processor->loadPresetAtIndex(presetIdx);
+            processor->loadPresetAtIndex(presetIdx, true);
         } else {
             // Re-set it to the preset already had
             processor->loadPresetAtIndex(processor->currentPreset);
@@ -219,12 +223,12 @@ public:
         }
     }
     
-    void actionListenerCallback (const String &message) override
+    void ddrmEventCallback (DDRMEvent event) override
     {
-        if (message.startsWith(String(ACTION_SET_CURRENT_PRESET_NAME))){
+        if (event == DDRMEvent::setCurrentPresetName){
             setPresetNameLabel ();
             
-        } else if (message.startsWith(String(ACTION_SET_CURRENT_PRESET_NAME_OUT_OF_SYNC))){
+        } else if (event == DDRMEvent::setCurrentPresetNameOutOfSync){
             if (!currentPresetSlidersOutOfSync) {
                 currentPresetSlidersOutOfSync = true;
                 if ((presetNameLabel.getText() != String(PRESET_NAME_DEFAULT_TEXT)) && (!presetNameLabel.getText().endsWith(String(PRESET_NAME_MODIFIED_TEXT)))){
@@ -232,7 +236,7 @@ public:
                     //saveToCurrentBankLocationButton.setEnabled(true);  // Enable save preset button as it is out of sync
                 }
             }
-        } else if (message.startsWith(String(ACTION_SET_CURRENT_PRESET_NAME_IN_SYNC))){
+        } else if (event == DDRMEvent::setCurrentPresetNameInSync){
             setPresetNameLabel ();
             if (currentPresetSlidersOutOfSync) {
                 currentPresetSlidersOutOfSync = false;
@@ -243,11 +247,11 @@ public:
                 }
             }
         }
-        else if (message.startsWith(String(ACTION_BANK_FILE_LOADED))){
+        else if (event == DDRMEvent::bankFileLoaded){
             loadedFileLabel.setText(processor->ddrmInterface->getPresetBankLoadedFilename() , dontSendNotification);
             presetNameLabel.setText(String(PRESET_NAME_DEFAULT_TEXT), dontSendNotification);
             enableBankTransportButtons();
-        } else if (message.startsWith(String(ACTION_CURRENT_PRESENT_SAVED_TO_BANK))){
+        } else if (event == DDRMEvent::currentPresetSavedToBank){
             //saveToCurrentBankLocationButton.setEnabled(false);
         }
     }
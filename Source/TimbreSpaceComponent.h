@@ -16,7 +16,7 @@
 
 
 class TimbreSpaceComponent: public Component,
-                            public ActionListener
+                            public DDRMEventListener
 
 {
 public:
@@ -30,7 +30,7 @@ public:
     
     ~TimbreSpaceComponent ()
     {
-        processor->timbreSpaceEngine->removeActionListener(this);  // Stop receivng messages from timbre space engine
+        processor->timbreSpaceEngine->removeEventListener(this);  // Stop receivng events from timbre space engine
     }
     
     void initialize (DdrmtimbreSpaceAudioProcessor* p)
@@ -38,12 +38,19 @@ public:
         processor = p;
         
         // Set up listeners
-        processor->timbreSpaceEngine->addActionListener(this);  // Receive messages from timbre space engine
+        processor->timbreSpaceEngine->addEventListener(this, {DDRMEvent::loadTimbreSpaceSolution,
+                                                              DDRMEvent::setIsComputingTimbreSpaceSolution,
+                                                              DDRMEvent::loadSelectedPointData,
+                                                              DDRMEvent::repaintTimbreSpace,
+                                                              DDRMEvent::setTimbreSpaceSlidersOutOfSync,
+                                                              DDRMEvent::setTimbreSpaceSlidersInSync,
+                                                              DDRMEvent::setTimbreSpaceXYToPresetNumber});  // Receive events from timbre space engine
         
         // Init variables and try to load solution (if any already present)
         setWantsKeyboardFocus(true);
         drawExtraInfo = true;
-        lastTimeMouseDragged = Time::currentTimeMillis();
+        drawVoronoiRegions = false;
+        voronoiImageRasterBuildCount = 0;
         initMainVariables();
         setStateFromProcessor ();
     }
@@ -75,9 +82,9 @@ public:
         }
     }
     
-    void setTimbreSpaceData (ValueTree solution)
+    void setTimbreSpaceData (const TimbreSpaceSolution& solution)
     {
-        if (solution.isValid()){
+        if (solution.hasPoints()){
             initMainVariables();
             data = solution;
             dataLoaded = true;
@@ -151,13 +158,12 @@ public:
             gBg.fillAll (Colours::black);
             
             // Draw big circles
-            for (int i=0; i<data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getNumChildren(); i++){
-                ValueTree point = data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(i);
-                float x = (float)point["x"] * getWidth();
-                float y = (float)point["y"] * getHeight();
-                float red = (float)point["r"];
-                float green = (float)point["g"];
-                float blue = (float)point["b"];
+            for (int i=0; i<data.getNumPoints(); i++){
+                float x = data.x[i] * getWidth();
+                float y = data.y[i] * getHeight();
+                float red = data.r[i];
+                float green = data.g[i];
+                float blue = data.b[i];
                 
                 Colour color1 = Colour::fromFloatRGBA(red, green, blue, bigCricleOpacity).withSaturation(saturation).withMultipliedBrightness(brightnessMultiplier);
                 Colour color2 = Colour::fromFloatRGBA(red, green, blue, 0.0f).withSaturation(saturation).withMultipliedBrightness(brightnessMultiplier);
@@ -167,13 +173,12 @@ public:
             }
             
             // Draw small circles
-            for (int i=0; i<data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getNumChildren(); i++){
-                ValueTree point = data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(i);
-                float x = (float)point["x"] * getWidth();
-                float y = (float)point["y"] * getHeight();
-                float red = (float)point["r"]; 
-                float green = (float)point["g"];
-                float blue = (float)point["b"];
+            for (int i=0; i<data.getNumPoints(); i++){
+                float x = data.x[i] * getWidth();
+                float y = data.y[i] * getHeight();
+                float red = data.r[i];
+                float green = data.g[i];
+                float blue = data.b[i];
                 
                 Colour color1 = Colour::fromFloatRGBA(red, green, blue, bigCricleOpacity).withSaturation(saturation).withMultipliedBrightness(brightnessMultiplier);
                 Colour color2 = Colour::fromFloatRGBA(red, green, blue, 0.0f).withSaturation(saturation).withMultipliedBrightness(brightnessMultiplier);
@@ -192,46 +197,42 @@ public:
             g.drawImage(backgroundImage, getLocalBounds().toFloat());
         }
         
+        // Draw Voronoi regions of the presets (if enabled and interpolation raster available)
+        if (drawVoronoiRegions){
+            const TimbreSpaceInterpolationRaster& raster = processor->timbreSpaceEngine->getInterpolationRaster();
+            if (raster.isBuilt()){
+                if (voronoiImage.isNull() || (voronoiImageRasterBuildCount != raster.getBuildCount())){
+                    updateVoronoiImage(raster);
+                }
+                g.drawImage(voronoiImage, getLocalBounds().toFloat());
+            }
+        }
+        
         // Draw preset circles, triangles and interpolation data
         if (drawExtraInfo) {
             g.setColour(trianglesColour);
             
             // Draw preset circles
             if (presetCircleRadius){
-                for (int i=0; i<data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getNumChildren(); i++){
-                    ValueTree point = data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(i);
-                    float x = (float)point["x"] * getWidth();
-                    float y = (float)point["y"] * getHeight();
+                for (int i=0; i<data.getNumPoints(); i++){
+                    float x = data.x[i] * getWidth();
+                    float y = data.y[i] * getHeight();
                     g.drawEllipse (x - presetCircleRadius, y - presetCircleRadius, presetCircleRadius * 2, presetCircleRadius * 2, presetCircleLineWidth);
                 }
             }
             
             // Draw triangles (if any)
-            for(int i=0; i < data.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER).getNumChildren(); i++){
-                ValueTree triangle = data.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER).getChild(i);
-                float x1 = (float)triangle["x1"] * getWidth();
-                float y1 = (float)triangle["y1"] * getHeight();
-                float x2 = (float)triangle["x2"] * getWidth();
-                float y2 = (float)triangle["y2"] * getHeight();
-                float x3 = (float)triangle["x3"] * getWidth();
-                float y3 = (float)triangle["y3"] * getHeight();
+            for(int i=0; i < data.getNumTriangles(); i++){
                 Path path;
-                path.addTriangle (x1, y1, x2, y2, x3, y3);
+                addTriangleToPath(path, i);
                 g.strokePath (path, stroke);
             }
             
             // Draw selected triangle (if any)
             if (selectedTriangleIdx > -1) {
                 g.setColour(selectedTriangleColour);
-                ValueTree triangle = data.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER).getChild(selectedTriangleIdx);
-                float x1 = (float)triangle["x1"] * getWidth();
-                float y1 = (float)triangle["y1"] * getHeight();
-                float x2 = (float)triangle["x2"] * getWidth();
-                float y2 = (float)triangle["y2"] * getHeight();
-                float x3 = (float)triangle["x3"] * getWidth();
-                float y3 = (float)triangle["y3"] * getHeight();
                 Path path;
-                path.addTriangle (x1, y1, x2, y2, x3, y3);
+                addTriangleToPath(path, selectedTriangleIdx);
                 g.strokePath (path, stroke);
                 g.setColour(selectedTriangleFillColour);
                 g.fillPath (path);
@@ -256,10 +257,12 @@ public:
                 }
                 
                 for (int i=0; i<selectedPointInterpolationData.size(); i++){
-                    int presetIdx = selectedPointInterpolationData[i].presetIdx;
-                    ValueTree point = data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(presetIdx);
-                    float x = (float)point["x"] * getWidth();
-                    float y = (float)point["y"] * getHeight();
+                    int pointIdx = selectedPointInterpolationData[i].pointIdx;
+                    if ((pointIdx < 0) || (pointIdx >= data.getNumPoints())){
+                        continue;  // Interpolation data not computed for the solution loaded in the component
+                    }
+                    float x = data.x[pointIdx] * getWidth();
+                    float y = data.y[pointIdx] * getHeight();
                     
                     float dist = selectedPointInterpolationData[i].presetDist;
                     float normDist = 1 - (dist - minDist)/(maxDist - minDist);  // Invert distance so closer ones are 1.0
@@ -273,7 +276,7 @@ public:
                     // Draw preset idx label
                     if (presetLabelFontSize) {
                         g.setFont(presetLabelFontSize);
-                        g.drawSingleLineText(String::formatted("#%i", (int)point["presetIdx"] + 1), x + 15.0f, y + 0.0f);
+                        g.drawSingleLineText(String::formatted("#%i", data.presetIdx[pointIdx] + 1), x + 15.0f, y + 0.0f);
                     }
                 }
             }
@@ -323,13 +326,10 @@ public:
     void mouseDrag(const MouseEvent& event) override
     {
         if (event.mouseWasDraggedSinceMouseDown() && dataLoaded){
-            int64 currentTime = Time::currentTimeMillis();
-            if (currentTime - lastTimeMouseDragged > MIN_MILLISECONDS_FOR_MOUSE_DRAG_UPDATE) {
-                float x = (float)event.getPosition().x / getWidth();
-                float y = (float)event.getPosition().y / getHeight();
-                processor->updateSpacePointAudioParametersFromMouseEvent(x, y);  // This will in its time trigger the loading of new preset
-                lastTimeMouseDragged = currentTime;
-            }
+            // Loading of the new preset is throttled by the timbre space engine (see TimbreSpaceEngine::selectPointInSpace)
+            float x = (float)event.getPosition().x / getWidth();
+            float y = (float)event.getPosition().y / getHeight();
+            processor->updateSpacePointAudioParametersFromMouseEvent(x, y);  // This will in its time trigger the loading of new preset
         }
     }
     
@@ -339,31 +339,35 @@ public:
             drawExtraInfo = !drawExtraInfo;
             repaint();
         }
+        if( k.getTextCharacter() == 'v' ) {
+            drawVoronoiRegions = !drawVoronoiRegions;
+            repaint();
+        }
         
         // Return true so key event is not passed to other consumers
         return true;
     }
     
-    void actionListenerCallback (const String &message) override
+    void ddrmEventCallback (DDRMEvent event) override
     {
-        if (message.startsWith(String(ACTION_LOAD_TS_SOLUTION))){
+        if (event == DDRMEvent::loadTimbreSpaceSolution){
             setTimbreSpaceData(processor->timbreSpaceEngine->getSolution());
             repaint();
         }
-        else if (message.startsWith(String(ACTION_SET_IS_COMPUTING_TS_SOLUTION))){
+        else if (event == DDRMEvent::setIsComputingTimbreSpaceSolution){
             isLoadingData = true;
             repaint();
         }
-        else if (message.startsWith(String(ACTION_LOAD_SELECTED_POINT_DATA))){
+        else if (event == DDRMEvent::loadSelectedPointData){
             selectedPointX = processor->timbreSpaceEngine->getSelectedPointX();
             selectedPointY = processor->timbreSpaceEngine->getSelectedPointY();
             selectedTriangleIdx = processor->timbreSpaceEngine->getSelectedTriangleIdx();
             selectedPointInterpolationData = processor->timbreSpaceEngine->getSelectedPointInterpolationData();
         }
-        else if (message.startsWith(String(ACTION_REPAINT))){
+        else if (event == DDRMEvent::repaintTimbreSpace){
             repaint();
         }
-        else if (message.startsWith(String(ACTION_SET_TS_SLIDERS_OUT_OF_SYNC))){
+        else if (event == DDRMEvent::setTimbreSpaceSlidersOutOfSync){
             if (!synthControlsOutOfSync){
                 selectedTriangleIdx = -1;
                 synthControlsOutOfSync = true;
@@ -371,19 +375,18 @@ public:
                 repaint();
             }
         }
-        else if (message.startsWith(String(ACTION_SET_TS_SLIDERS_IN_SYNC))){
+        else if (event == DDRMEvent::setTimbreSpaceSlidersInSync){
             if (synthControlsOutOfSync){
                 synthControlsOutOfSync = false;
                 repaint();
             }
         }
-        else if (message.startsWith(String(ACTION_SET_TS_XY_TO_PRESET_NUMBER))){
+        else if (event == DDRMEvent::setTimbreSpaceXYToPresetNumber){
             if (dataLoaded){
                 int selectedPointIdx = processor->timbreSpaceEngine->getSelectedPresetPointIdx();
                 if (selectedPointIdx > -1){
-                    ValueTree point = data.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(selectedPointIdx);
-                    selectedPointX = (float)point["x"];
-                    selectedPointY = (float)point["y"];
+                    selectedPointX = data.x[selectedPointIdx];
+                    selectedPointY = data.y[selectedPointIdx];
                 } else {
                     selectedPointX = -1.0;
                     selectedPointY = -1.0;
@@ -398,22 +401,55 @@ public:
     
 private:
     DdrmtimbreSpaceAudioProcessor* processor;
-    ValueTree data;
+    TimbreSpaceSolution data;
     bool isLoadingData;
     bool dataLoaded;
     
     Image backgroundImage;
     bool backgroundNeedsUpdate;
     bool drawExtraInfo;
+    bool drawVoronoiRegions;
+    Image voronoiImage;
+    uint32 voronoiImageRasterBuildCount;  // Build count of the raster from which voronoiImage was drawn
     float selectedPointX;
     float selectedPointY;
     int selectedTriangleIdx;
     PresetDistancePairsToInterpolate selectedPointInterpolationData;
     bool synthControlsOutOfSync; // This is used to indicate wether synth controls correpsond to a position in the timbre space or are out of sync
     
-    int64 lastTimeMouseDragged;
     
     Image overlayImage;
     
+    void updateVoronoiImage (const TimbreSpaceInterpolationRaster& raster)
+    {
+        // Draws the borders between Voronoi regions (raster cells whose nearest preset differs from the nearest preset of
+        // the cell to the right or below)
+        int size = raster.getSize();
+        voronoiImage = Image(Image::ARGB, size, size, true);
+        Image::BitmapData bitmap (voronoiImage, Image::BitmapData::writeOnly);
+        Colour borderColour = Colour(TIMBRE_SPACE_VORONOI_COLOUR);
+        for (int row=0; row<size; row++){
+            for (int column=0; column<size; column++){
+                int nearestPointIdx = raster.getNearestPointIdx(row * size + column);
+                bool isBorder = ((column < size - 1) && (raster.getNearestPointIdx(row * size + column + 1) != nearestPointIdx))
+                             || ((row < size - 1) && (raster.getNearestPointIdx((row + 1) * size + column) != nearestPointIdx));
+                if (isBorder){
+                    bitmap.setPixelColour(column, row, borderColour);
+                }
+            }
+        }
+        voronoiImageRasterBuildCount = raster.getBuildCount();
+    }
+    
+    void addTriangleToPath (Path& path, int triangleIdx)
+    {
+        uint32 p1 = data.triangles[3 * triangleIdx];
+        uint32 p2 = data.triangles[3 * triangleIdx + 1];
+        uint32 p3 = data.triangles[3 * triangleIdx + 2];
+        path.addTriangle (data.x[p1] * getWidth(), data.y[p1] * getHeight(),
+                          data.x[p2] * getWidth(), data.y[p2] * getHeight(),
+                          data.x[p3] * getWidth(), data.y[p3] * getHeight());
+    }
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimbreSpaceComponent);
 };
@@ -8,128 +8,124 @@
 
 #pragma once
 
+#include <atomic>
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "defines.h"
+#include "DDRMEventBus.h"
+#include "DDRMThrottle.h"
+#include "TimbreSpaceSolution.h"
+#include "TimbreSpaceSolutionCache.h"
+#include "TimbreSpacePointLocator.h"
+#include "TimbreSpaceInterpolationRaster.h"
 #include <delaunator/delaunator.h>
 #include <tapkee/tapkee.hpp>
 
 
-class TimbreSpaceEngine: public ActionBroadcaster
+class TimbreSpaceEngine: public ActionBroadcaster,
+                         public DDRMEventBus
 
 {
 public:
-    TimbreSpaceEngine ()
+    TimbreSpaceEngine (): selectPointThrottle (TIMBRE_SPACE_UPDATE_INTERVAL_MS, [this] { resolveRequestedPointInSpace(); })
     {
         selectedPointX = -1.0;
         selectedPointY = -1.0;
         selectedTriangleIdx = 0;
         selectedPresetPointIdx = -1;
         synthSlidersOutOfSync = true;
-        
-        // Set last timbre space was updated from position parameter automation to now
-        lastTimeInterpolatedPresetLoaded = Time::currentTimeMillis();
-        
-        solution = ValueTree(TIMBRE_SPACE_SOLUTION_IDENTIFIER);
+        requestedPointX = -1.0;
+        requestedPointY = -1.0;
+        hasNewComputedSolution = false;
+        hasNewBuiltRaster = false;
+        builtRasterSolutionId = 0;
+        solutionId = 0;
+        interpolationRasterEnabled = false;  // Opt-in, as it quantises selected points to the raster cells
+        snapToNearestPreset = false;
     }
     
     ~TimbreSpaceEngine ()
     {
+        // Cancel background computation and wait for it to exit (without timeout, as the job uses members of the engine)
+        computePool.removeAllJobs(true, -1);
+        
         // De-register action listeners
         removeAllActionListeners();
     }
     
-    void computeMapPoints(timbreSpaceInputDataMatrix data)
+    void computeSolutionInBackground(timbreSpaceInputDataMatrix data)
     {
-        // Filter out rows of the matrix which correspond to empty presets
-        // That will be rows in which the sum of all of its values is not above some threshold (hence all being 0s or noise).
-        // We also need to keep a record of the original matrix row number and the corresponding rows in the resulting filtered
-        // matrix as row numbers of the original matrix correspond to preset IDXs.
-        
-        // Filter input data
-        timbreSpaceInputDataMatrix filteredData;
-        std::vector<int> presetIDXmap;
-        for (int i=0; i < data.size(); i++){
-            float rowSum = 0.0;
-            for (int j=0; j < data[i].size(); j++){
-                rowSum += data[i][j];
-            }
-            if (rowSum > EMPTY_PRESET_SUM_THRESHOLD){
-                filteredData.push_back(data[i]);
-                presetIDXmap.push_back(i);
-            }
-        }
-        
-        // Do map computation
-        /*
-         The function doing map computation is expected to outputs a ValueTree
-         object representing the "solution" of the map computation. The ValueTree must
-         have as many children as points in the input data. Each children must in its
-         turn be a nested ValueTree with the following properties:
-         - presetIdx: the preset index (of the bank) to which the point corresponds
-         - x: x position in a normalized [0-1] coordinate space
-         - y: y position in a normalized [0-1] coordinate space
-         - r: r component of an RGB colouring for the point (range [0-1])
-         - g: g component of an RGB colouring for the point (range [0-1])
-         - b: b component of an RGB colouring for the point (range [0-1])
-         
-         Input "data" is of type timbreSpaceInputDataMatrix, which is a matrix of floats
-         (implemented as a vector of vectors) in which each row corresponds to one preset
-         of the loaded bank. The number of rows in "data" could be different than the number
-         of presets in the bank as some presets might not be used for map computation (e.g.
-         empty pesets). To know which preset corresponds to which row of "data", the
-         "presetIDXmap" argument is passed which is a vector of integers that map "data" rows
-         to the corresponding preset indexes in the loaded bank.
-         */
-        ValueTree solutionPoints = computeMapUsingMethod(filteredData, presetIDXmap, DIMENSIONALITY_REDUCTION_METHOD_DEFAULT);
-        
-        // Store results in class member
-        if (hasMapPointsComputed()){
-            // If already existing child with name, remove it
-            solution.removeChild(solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER), nullptr);
+        // Computes a new solution (map points and triangulation) for the given data in a worker thread. If a
+        // solution is already being computed, that computation is cancelled. When the new solution is ready
+        // the timbreSpaceSolutionComputed event is posted and the solution can be loaded with loadComputedSolution.
+        ComputeSolutionJobSelector computeJobs;
+        computePool.removeAllJobs(true, 0, &computeJobs);  // Signal running job to exit (it is deleted by the pool when it does)
+        computeGeneration++;
+        computePool.addJob(new ComputeSolutionJob(*this, data, computeGeneration), true);
+    }
+    
+    bool loadComputedSolution()
+    {
+        // Replaces the current solution with the last solution computed in the background (message thread).
+        // Returns false if no new solution is available.
+        const ScopedLock sl (computedSolutionLock);
+        if (!hasNewComputedSolution){
+            return false;
         }
-        solution.appendChild(solutionPoints, nullptr);
+        solution = std::move(computedSolution);
+        computedSolution.clear();
+        hasNewComputedSolution = false;
+        rebuildPointLocation();
+        return true;
     }
     
-    void computeTriangulation()
+    bool loadBuiltRaster()
     {
-        if (!solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).isValid()){
-            #if JUCE_DEBUG
-                logMessage("Can't compute triangulation as no map points have not yet been computed");
-            #endif
-            return;
+        // Replaces the interpolation raster with the last raster built in the background (message thread). Rasters
+        // built for a solution which is no longer loaded are discarded. Returns false if no raster was loaded.
+        const ScopedLock sl (computedSolutionLock);
+        if (!hasNewBuiltRaster){
+            return false;
         }
-        
-        // Compute delanuay triangles and convert to coordinates
-        ValueTree solutionPoints = solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER);
-        std::vector<double> coords;
-        for (int i=0; i<solutionPoints.getNumChildren(); i++){
-            coords.push_back((double)solutionPoints.getChild(i)["x"]);
-            coords.push_back((double)solutionPoints.getChild(i)["y"]);
+        hasNewBuiltRaster = false;
+        if ((builtRasterSolutionId != solutionId) || !interpolationRasterEnabled){
+            builtRaster.clear();
+            return false;
         }
-                             
-        ValueTree solutionTriangles = ValueTree(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER);
-        delaunator::Delaunator d(coords);
-        for(std::size_t i = 0; i < d.triangles.size(); i+=3) {
-            ValueTree solutionTriangle = ValueTree(TIMBRE_SPACE_SOLUTION_TRIANGLE_IDENTIFIER);
-            solutionTriangle.setProperty("x1", d.coords[2 * d.triangles[i]], nullptr);
-            solutionTriangle.setProperty("y1", d.coords[2 * d.triangles[i] + 1], nullptr);
-            solutionTriangle.setProperty("x2", d.coords[2 * d.triangles[i + 1]], nullptr);
-            solutionTriangle.setProperty("y2", d.coords[2 * d.triangles[i + 1] + 1], nullptr);
-            solutionTriangle.setProperty("x3", d.coords[2 * d.triangles[i + 2]], nullptr);
-            solutionTriangle.setProperty("y3", d.coords[2 * d.triangles[i + 2] + 1], nullptr);
-            solutionTriangle.setProperty("preset1Idx", (int)d.triangles[i], nullptr);
-            solutionTriangle.setProperty("preset2Idx", (int)d.triangles[i + 1], nullptr);
-            solutionTriangle.setProperty("preset3Idx", (int)d.triangles[i + 2], nullptr);
-            solutionTriangles.appendChild(solutionTriangle, nullptr);
-        }
-        if (hasTrianglesComputed()){
-         // If already existing child with name, remove it
-            solution.removeChild(solution.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER), nullptr);
-        }
-        solution.appendChild(solutionTriangles, nullptr);
+        interpolationRaster.swap(builtRaster);
+        builtRaster.clear();
+        postEvent(DDRMEvent::repaintTimbreSpace);  // Voronoi overlay is drawn from the raster
+        return true;
+    }
+    
+    bool isComputingSolution()
+    {
+        return computePool.getNumJobs() > 0;
     }
     
     void selectPointInSpace(float x, float y)
+    {
+        // Requests the selection of a point in the timbre space (mouse drag, automation)
+        // coordinates can be updated individually if either x or y are set to -1.0f
+        // Requests are throttled so that interpolation and loading of the interpolated preset happen at most once
+        // every TIMBRE_SPACE_UPDATE_INTERVAL_MS, always with the newest requested point (see DDRMThrottle)
+        if (x != -1.0f){
+            requestedPointX = x;
+        }
+        if (y != -1.0f){
+            requestedPointY = y;
+        }
+        selectPointThrottle.request();
+    }
+    
+    void cancelPendingPointInSpaceSelection()
+    {
+        // Drops a throttled point selection that has not been resolved yet (e.g. because a preset has been loaded)
+        selectPointThrottle.cancel();
+        requestedPointX = -1.0;
+        requestedPointY = -1.0;
+    }
+    
+    void resolveRequestedPointInSpace()
     {
         if (!solutionComputed()){
             #if JUCE_DEBUG
@@ -139,18 +135,25 @@ public:
         }
         
         // Store selected point in class member
-        // coordinates can be updated individually if either x or y are set to -1.0f
-        if (x != -1.0f){
-            selectedPointX = x;
+        if (requestedPointX != -1.0f){
+            selectedPointX = requestedPointX;
         }
-        if (y != -1.0f){
-            selectedPointY = y;
+        if (requestedPointY != -1.0f){
+            selectedPointY = requestedPointY;
         }
+        requestedPointX = -1.0;
+        requestedPointY = -1.0;
         selectedPresetPointIdx = -1; // Points do not correspond to any specific preset
         selectedTriangleIdx = -1; // Reset selected triangle idx
         
         // Get interpolation data
-        selectedPointInterpolationData = getInterpolationDataForPointUsingTriangulation();
+        if (snapToNearestPreset){
+            selectedPointInterpolationData = getInterpolationDataForNearestPreset();
+        } else if (interpolationRaster.isBuilt()){
+            selectedPointInterpolationData = getInterpolationDataForPointUsingRaster();
+        } else {
+            selectedPointInterpolationData = getInterpolationDataForPointUsingTriangulation();
+        }
         //selectedPointInterpolationData = getInterpolationDataForPointUsingNN(10);
         
         #if JUCE_DEBUG
@@ -187,7 +190,7 @@ public:
         return selectedPresetPointIdx;
     }
     
-    ValueTree getSolution()
+    const TimbreSpaceSolution& getSolution()
     {
         return solution;
     }
@@ -196,13 +199,45 @@ public:
     {
         return selectedPointInterpolationData;
     }
+    
+    const TimbreSpaceInterpolationRaster& getInterpolationRaster()
+    {
+        return interpolationRaster;
+    }
+    
+    void setInterpolationRasterEnabled(bool enabled)
+    {
+        // When enabled, interpolation data of selected points is fetched from a raster precomputed in the background
+        // when the solution is loaded (see TimbreSpaceInterpolationRaster) instead of being computed for each selected
+        // point. Interpolation data is then that of the centre of the raster cell of the selected point (positions are
+        // quantised to TIMBRE_SPACE_RASTER_SIZE steps). Until the raster is ready, selected points are resolved without it.
+        // Disabled by default.
+        interpolationRasterEnabled = enabled;
+        rebuildPointLocation();
+    }
+    
+    bool isInterpolationRasterEnabled()
+    {
+        return interpolationRasterEnabled;
+    }
+    
+    void setSnapToNearestPreset(bool enabled)
+    {
+        // When enabled, selecting a point in the space loads the preset nearest to it instead of interpolating
+        snapToNearestPreset = enabled;
+    }
+    
+    bool isSnapToNearestPresetEnabled()
+    {
+        return snapToNearestPreset;
+    }
                              
     bool hasMapPointsComputed() {
-        return solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).isValid();
+        return solution.hasPoints();
     }
 
     bool hasTrianglesComputed() {
-        return solution.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER).isValid();
+        return solution.hasTriangles();
     }
 
     bool solutionComputed() {
@@ -230,14 +265,24 @@ public:
         state.setProperty(STATE_TIMBRE_SPACE_SELECTED_TRIANGLE_IDX_IDENTIFIER, selectedTriangleIdx, nullptr);
         state.setProperty(STATE_TIMBRE_SPACE_SELECTED_PRESET_IDX_IDENTIFIER, selectedPresetPointIdx, nullptr);
         state.setProperty(STATE_TIMBRE_SPACE_OUT_OF_SYNC, synthSlidersOutOfSync, nullptr);
-        state.appendChild(solution, nullptr);
+        state.setProperty(STATE_TIMBRE_SPACE_INTERPOLATION_RASTER, interpolationRasterEnabled, nullptr);
+        state.setProperty(STATE_TIMBRE_SPACE_SNAP_TO_NEAREST_PRESET, snapToNearestPreset, nullptr);
+        state.appendChild(solution.toValueTree(), nullptr);
         return state;
     }
     
     void loadState(ValueTree state)
     {
+        if (state.hasProperty(STATE_TIMBRE_SPACE_INTERPOLATION_RASTER)){
+            interpolationRasterEnabled = (bool)state.getProperty(STATE_TIMBRE_SPACE_INTERPOLATION_RASTER);
+        }
+        if (state.hasProperty(STATE_TIMBRE_SPACE_SNAP_TO_NEAREST_PRESET)){
+            snapToNearestPreset = (bool)state.getProperty(STATE_TIMBRE_SPACE_SNAP_TO_NEAREST_PRESET);
+        }
+        
         if (state.getChildWithName(TIMBRE_SPACE_SOLUTION_IDENTIFIER).isValid()){
-            solution = state.getChildWithName(TIMBRE_SPACE_SOLUTION_IDENTIFIER);
+            solution.loadFromValueTree(state.getChildWithName(TIMBRE_SPACE_SOLUTION_IDENTIFIER));
+            rebuildPointLocation();
             
             // Only load rest of state if solution is present
             if (state.hasProperty(STATE_TIMBRE_SPACE_SELECTED_POINT_X_IDENTIFIER)){
@@ -264,18 +309,18 @@ public:
     
     void loadSelectedPointDataInTimbreSpaceComponentAndRepaint ()
     {
-        sendActionMessage(ACTION_LOAD_SELECTED_POINT_DATA);
-        sendActionMessage(ACTION_REPAINT);
+        postEvent(DDRMEvent::loadSelectedPointData);
+        postEvent(DDRMEvent::repaintTimbreSpace);
     }
     
     void loadSolutionDataInTimbreSpaceComponent()
     {
-        sendActionMessage(ACTION_LOAD_TS_SOLUTION);
+        postEvent(DDRMEvent::loadTimbreSpaceSolution);
     }
     
     void setIsLoadingSolutionInTimbreSpaceComponent()
     {
-        sendActionMessage(ACTION_SET_IS_COMPUTING_TS_SOLUTION);
+        postEvent(DDRMEvent::setIsComputingTimbreSpaceSolution);
     }
     
     void setTimbreSpaceComponentSlidersSyncStatus()
@@ -289,28 +334,29 @@ public:
     
     void setTimbreSpaceComponentOutOfSyncWithSliders()
     {
-        sendActionMessage(ACTION_SET_TS_SLIDERS_OUT_OF_SYNC);
+        postEvent(DDRMEvent::setTimbreSpaceSlidersOutOfSync);
     }
     
     void setTimbreSpaceComponentInSyncWithSliders()
     {
-        sendActionMessage(ACTION_SET_TS_SLIDERS_IN_SYNC);
+        postEvent(DDRMEvent::setTimbreSpaceSlidersInSync);
     }
     
     void setTimbreSpaceComponentXYToPresetNumber(int presetIdx)
     {
+        cancelPendingPointInSpaceSelection();  // Preset selection wins over an older point selection
+
         // Update selectedPresetPointIdx and set it to the solution preset index which corresponds to the selected
         // preset bank index. These two indices might be different if when creating the timbre space some presets
         // get filtered out
         selectedPresetPointIdx = -1;
-        for (int i=0; i<solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getNumChildren(); i++){
-            ValueTree point = solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(i);
-            if ((int)point["presetIdx"] ==  presetIdx){
+        for (int i=0; i<solution.getNumPoints(); i++){
+            if (solution.presetIdx[i] == presetIdx){
                 selectedPresetPointIdx = i;
                 break;
             }
         }
-        sendActionMessage(ACTION_SET_TS_XY_TO_PRESET_NUMBER);
+        postEvent(DDRMEvent::setTimbreSpaceXYToPresetNumber);
     }
     
     bool isSynthSlidersOutOfSync(){
@@ -319,14 +365,266 @@ public:
     
 private:
     
-    ValueTree solution;
+    TimbreSpaceSolution solution;
+    TimbreSpacePointLocator pointLocator;  // Rebuilt every time solution changes
+    TimbreSpaceInterpolationRaster interpolationRaster;  // Rebuilt every time solution changes (if enabled)
+    bool interpolationRasterEnabled;
+    bool snapToNearestPreset;
     float selectedPointX;
     float selectedPointY;
     int selectedTriangleIdx;
     int selectedPresetPointIdx;
     bool synthSlidersOutOfSync; // This is used to indicate wether synth controls correpsond to a position in the timbre space or are out of sync
     PresetDistancePairsToInterpolate selectedPointInterpolationData;
-    int64 lastTimeInterpolatedPresetLoaded;
+    float requestedPointX;  // Newest requested point not yet resolved (-1.0 if coordinate not requested)
+    float requestedPointY;
+    DDRMThrottle selectPointThrottle;
+    
+    // Background computation of solutions
+    
+    class ComputeSolutionJob: public ThreadPoolJob
+    {
+    public:
+        /*
+         Computes a timbre space solution in a worker thread of the engine's computePool. The job checks
+         whether it should exit (because a newer computation was requested) between computation stages and,
+         through tapkee's cancel function, while running dimensionality reduction (including between t-SNE
+         iterations). Only completed solutions of the latest requested computation are delivered.
+         */
+        
+        ComputeSolutionJob (TimbreSpaceEngine& e, const timbreSpaceInputDataMatrix& d, uint32 g)
+            : ThreadPoolJob ("Timbre space computation"), engine (e), data (d), generation (g)
+        {
+        }
+        
+        JobStatus runJob () override
+        {
+            getCurrentJob() = this;
+            TimbreSpaceSolution newSolution;
+            try {
+                engine.computeSolution(data, newSolution);
+            } catch (const tapkee::cancelled_exception&) {
+                newSolution.clear();
+            }
+            getCurrentJob() = nullptr;
+            if (!shouldExit()){
+                engine.setComputedSolution(std::move(newSolution), generation);
+            }
+            return jobHasFinished;
+        }
+        
+        static ThreadPoolJob*& getCurrentJob ()
+        {
+            // Job running in the current thread (used by the tapkee cancel function which can't have a context)
+            static thread_local ThreadPoolJob* currentJob = nullptr;
+            return currentJob;
+        }
+        
+    private:
+        TimbreSpaceEngine& engine;
+        timbreSpaceInputDataMatrix data;
+        uint32 generation;
+    };
+    
+    class ComputeSolutionJobSelector: public ThreadPool::JobSelector
+    {
+    public:
+        // Selects solution computations only (raster builds for the current solution are kept)
+        bool isJobSuitable (ThreadPoolJob* job) override
+        {
+            return dynamic_cast<ComputeSolutionJob*>(job) != nullptr;
+        }
+    };
+    
+    class BuildRasterJob: public ThreadPoolJob
+    {
+    public:
+        /*
+         Builds the interpolation raster of a copy of the current solution in the worker thread of computePool, so
+         the message thread is not blocked. The raster is delivered with the id of the solution it was built for.
+         */
+        
+        BuildRasterJob (TimbreSpaceEngine& e, const TimbreSpaceSolution& s, uint32 id)
+            : ThreadPoolJob ("Timbre space raster"), engine (e), rasterSolution (s), solutionId (id)
+        {
+        }
+        
+        JobStatus runJob () override
+        {
+            ComputeSolutionJob::getCurrentJob() = this;  // For isComputationCancelled
+            #if JUCE_DEBUG
+                double startTime = Time::getMillisecondCounterHiRes();
+            #endif
+            TimbreSpacePointLocator locator;
+            locator.build(&rasterSolution);
+            TimbreSpaceInterpolationRaster raster;
+            bool built = raster.build(rasterSolution, locator, TIMBRE_SPACE_RASTER_SIZE, &isComputationCancelled);
+            ComputeSolutionJob::getCurrentJob() = nullptr;
+            if (built && !shouldExit()){
+                #if JUCE_DEBUG
+                    engine.logMessage(String::formatted("Built interpolation raster in %.1f ms", Time::getMillisecondCounterHiRes() - startTime));
+                #endif
+                engine.setBuiltRaster(raster, solutionId);
+            }
+            return jobHasFinished;
+        }
+        
+    private:
+        TimbreSpaceEngine& engine;
+        TimbreSpaceSolution rasterSolution;
+        uint32 solutionId;
+    };
+    
+    uint32 solutionId;  // Changes every time solution changes (message thread)
+    std::atomic<uint32> computeGeneration { 0 };
+    TimbreSpaceSolution computedSolution;  // Last solution computed in the background, not yet loaded
+    bool hasNewComputedSolution;
+    CriticalSection computedSolutionLock;
+    TimbreSpaceSolutionCache solutionCache;  // Only used from the worker thread
+    TimbreSpaceInterpolationRaster builtRaster;  // Last raster built in the background, not yet loaded
+    uint32 builtRasterSolutionId;
+    bool hasNewBuiltRaster;
+    ThreadPool computePool { 1 };  // Declared after the members used by its job so it is destroyed before them
+    
+    static bool isComputationCancelled ()
+    {
+        ThreadPoolJob* job = ComputeSolutionJob::getCurrentJob();
+        return (job != nullptr) && job->shouldExit();
+    }
+    
+    void setComputedSolution (TimbreSpaceSolution newSolution, uint32 generation)
+    {
+        // Called from the worker thread when a computation finishes. Solutions of old computations are discarded.
+        // The event is also posted if the computation failed (newSolution has no points) so the timbre space component
+        // stops showing the computing status.
+        if (generation != computeGeneration){
+            return;
+        }
+        {
+            const ScopedLock sl (computedSolutionLock);
+            hasNewComputedSolution = newSolution.hasPoints();
+            computedSolution = std::move(newSolution);
+        }
+        postEvent(DDRMEvent::timbreSpaceSolutionComputed);
+    }
+    
+    void setBuiltRaster (TimbreSpaceInterpolationRaster& raster, uint32 rasterSolutionId)
+    {
+        // Called from the worker thread when a raster has been built (its contents are moved to builtRaster)
+        {
+            const ScopedLock sl (computedSolutionLock);
+            builtRaster.swap(raster);
+            builtRasterSolutionId = rasterSolutionId;
+            hasNewBuiltRaster = true;
+        }
+        postEvent(DDRMEvent::timbreSpaceRasterBuilt);
+    }
+    
+    void computeSolution (const timbreSpaceInputDataMatrix& data, TimbreSpaceSolution& newSolution)
+    {
+        // Computes map points and triangulation for the given data (worker thread), or loads them from the solution
+        // cache if the same data has already been computed. Does not access any member of the engine other than
+        // solutionCache and logging. newSolution has no points if cancelled or no points were computed.
+        newSolution.clear();
+        
+        // Filter out rows of the matrix which correspond to empty presets
+        // That will be rows in which the sum of all of its values is not above some threshold (hence all being 0s or noise).
+        // We also need to keep a record of the original matrix row number and the corresponding rows in the resulting filtered
+        // matrix as row numbers of the original matrix correspond to preset IDXs.
+        timbreSpaceInputDataMatrix filteredData;
+        std::vector<int> presetIDXmap;
+        for (int i=0; i < data.size(); i++){
+            float rowSum = 0.0;
+            for (int j=0; j < data[i].size(); j++){
+                rowSum += data[i][j];
+            }
+            if (rowSum > EMPTY_PRESET_SUM_THRESHOLD){
+                filteredData.push_back(data[i]);
+                presetIDXmap.push_back(i);
+            }
+        }
+        if (filteredData.size() == 0){
+            return;
+        }
+        
+        // Check if solution is in cache
+        String methodName = DIMENSIONALITY_REDUCTION_METHOD_DEFAULT;
+        String cacheKey = TimbreSpaceSolutionCache::computeKey(filteredData, presetIDXmap, methodName, getMethodParametersDescription());
+        if (solutionCache.load(cacheKey, newSolution)){
+            #if JUCE_DEBUG
+                logMessage("Loaded timbre space solution from cache");
+            #endif
+            return;
+        }
+        
+        // Do map computation
+        /*
+         The function doing map computation is expected to add the points of the "solution"
+         of the map computation to the given TimbreSpaceSolution object. It must add as many
+         points as points in the input data, each of them with the following values:
+         - presetIdx: the preset index (of the bank) to which the point corresponds
+         - x: x position in a normalized [0-1] coordinate space
+         - y: y position in a normalized [0-1] coordinate space
+         - r: r component of an RGB colouring for the point (range [0-1])
+         - g: g component of an RGB colouring for the point (range [0-1])
+         - b: b component of an RGB colouring for the point (range [0-1])
+         
+         Input "data" is of type timbreSpaceInputDataMatrix, which is a matrix of floats
+         (implemented as a vector of vectors) in which each row corresponds to one preset
+         of the loaded bank. The number of rows in "data" could be different than the number
+         of presets in the bank as some presets might not be used for map computation (e.g.
+         empty pesets). To know which preset corresponds to which row of "data", the
+         "presetIDXmap" argument is passed which is a vector of integers that map "data" rows
+         to the corresponding preset indexes in the loaded bank.
+         */
+        computeMapUsingMethod(filteredData, presetIDXmap, methodName, newSolution);
+        if (!newSolution.hasPoints() || isComputationCancelled()){
+            newSolution.clear();
+            return;
+        }
+        
+        computeTriangulation(newSolution);
+        if (!solutionCache.store(cacheKey, newSolution)){
+            logMessage("Could not store timbre space solution in cache");
+        }
+    }
+    
+    String getMethodParametersDescription()
+    {
+        // Parameters used by doDimensionalityReduction (part of the solution cache key). Other
+        // parameters use tapkee defaults, TIMBRE_SPACE_CACHE_VERSION must be increased if they change.
+        return "target_dimension=2,3";
+    }
+    
+    void computeTriangulation(TimbreSpaceSolution& newSolution)
+    {
+        // Compute delanuay triangles and halfedges of the solution points
+        std::vector<double> coords;
+        for (int i=0; i<newSolution.getNumPoints(); i++){
+            coords.push_back((double)newSolution.x[i]);
+            coords.push_back((double)newSolution.y[i]);
+        }
+        
+        delaunator::Delaunator d(coords);
+        newSolution.triangles.assign(d.triangles.begin(), d.triangles.end());
+        newSolution.halfedges.resize(d.halfedges.size());
+        for (std::size_t i = 0; i < d.halfedges.size(); i++) {
+            newSolution.halfedges[i] = (d.halfedges[i] == delaunator::INVALID_INDEX) ? -1 : (int32)d.halfedges[i];
+        }
+    }
+    
+    void rebuildPointLocation ()
+    {
+        // Rebuilds the structures used to resolve selected points (must be called every time solution changes). The
+        // point locator is rebuilt right away, the interpolation raster (if enabled) is built in the background and
+        // loaded with loadBuiltRaster.
+        solutionId++;
+        pointLocator.build(&solution);
+        interpolationRaster.clear();
+        if (interpolationRasterEnabled && solution.hasPoints()){
+            computePool.addJob(new BuildRasterJob(*this, solution, solutionId), true);
+        }
+    }
     
     void logMessage (const String& message)
     {
@@ -336,14 +634,8 @@ private:
     
     void loadInterpolatedPresetInProcessor ()
     {
-        // Load interpolated preset
-        int64 currentTime = Time::currentTimeMillis();
-        if (currentTime - lastTimeInterpolatedPresetLoaded > MIN_MILLISECONDS_FOR_AUTOMATION_TIMBRE_SPACE_UPDATE){
-            // Because loading the preset to the synth involves sending many MIDI messages, make sure we don't trigger that action
-            // More than X times per second
-            sendActionMessage(ACTION_LOAD_INTERPOLATED_PRESET);
-            lastTimeInterpolatedPresetLoaded = currentTime;
-        }
+        // Load interpolated preset (rate is limited by selectPointThrottle)
+        sendEventNow(DDRMEvent::loadInterpolatedPreset);  // Synchronous, processor-internal event
     }
     
     std::vector<float> normalizeFloatVector(std::vector<float> v)
@@ -367,15 +659,7 @@ private:
                 logMessage("No solution computed, can't get triangle for point");
             #endif
         } else {
-            for(int i=0; i < solution.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER).getNumChildren(); i++){
-                ValueTree triangle = solution.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER).getChild(i);
-                if (isInTriangle(x, y,
-                                 (float)triangle["x1"], (float)triangle["y1"],
-                                 (float)triangle["x2"], (float)triangle["y2"],
-                                 (float)triangle["x3"], (float)triangle["y3"])){
-                    triangleIdx = i;
-                }
-            }
+            triangleIdx = pointLocator.findTriangle(x, y);
         }
         return triangleIdx;
     }
@@ -412,57 +696,33 @@ private:
             preset1Dist = preset2Dist = preset3Dist = -1.0;
             
         } else {
-            ValueTree triangle = solution.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER).getChild(triangleIdx);
-            preset1Idx = (int)triangle["preset1Idx"];
-            preset2Idx = (int)triangle["preset2Idx"];
-            preset3Idx = (int)triangle["preset3Idx"];
-            preset1Dist = euclideanDistance(x, y, (float)solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(preset1Idx)["x"], (float)solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(preset1Idx)["y"]);
-            preset2Dist = euclideanDistance(x, y, (float)solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(preset2Idx)["x"], (float)solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(preset2Idx)["y"]);
-            preset3Dist = euclideanDistance(x, y, (float)solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(preset3Idx)["x"], (float)solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(preset3Idx)["y"]);
+            preset1Idx = (int)solution.triangles[3 * triangleIdx];
+            preset2Idx = (int)solution.triangles[3 * triangleIdx + 1];
+            preset3Idx = (int)solution.triangles[3 * triangleIdx + 2];
+            preset1Dist = euclideanDistance(x, y, solution.x[preset1Idx], solution.y[preset1Idx]);
+            preset2Dist = euclideanDistance(x, y, solution.x[preset2Idx], solution.y[preset2Idx]);
+            preset3Dist = euclideanDistance(x, y, solution.x[preset3Idx], solution.y[preset3Idx]);
         }
         
+        // Triangle vertices are point indexes of the solution, which are mapped to the preset indexes of the bank
         PresetDistancePairsToInterpolate output;
         PresetDistanceStruct pd;
-        pd.presetIdx = preset1Idx;
+        pd.pointIdx = preset1Idx;
+        pd.presetIdx = (preset1Idx > -1) ? solution.presetIdx[preset1Idx] : -1;
         pd.presetDist = preset1Dist;
         output.push_back(pd);
-        pd.presetIdx = preset2Idx;
+        pd.pointIdx = preset2Idx;
+        pd.presetIdx = (preset2Idx > -1) ? solution.presetIdx[preset2Idx] : -1;
         pd.presetDist = preset2Dist;
         output.push_back(pd);
-        pd.presetIdx = preset3Idx;
+        pd.pointIdx = preset3Idx;
+        pd.presetIdx = (preset3Idx > -1) ? solution.presetIdx[preset3Idx] : -1;
         pd.presetDist = preset3Dist;
         output.push_back(pd);
         
         return output;
     }
     
-    bool isInTriangle(float px, float py, float ax, float ay, float bx, float by, float cx, float cy)
-    {
-        // Target point (px, py)
-        // Triangle coodinates (ax, ay), (bx, by), (cx, cy)
-        //credit: http://www.blackpawn.com/texts/pointinpoly/default.html
-        
-        float v0_0 = cx - ax;
-        float v0_1 = cy - ay;
-        float v1_0 = bx - ax;
-        float v1_1 = by - ay;
-        float v2_0 = px - ax;
-        float v2_1 = py - ay;
-        
-        float dot00 = (v0_0 * v0_0) + (v0_1 * v0_1);
-        float dot01 = (v0_0 * v1_0) + (v0_1 * v1_1);
-        float dot02 = (v0_0 * v2_0) + (v0_1 * v2_1);
-        float dot11 = (v1_0 * v1_0) + (v1_1 * v1_1);
-        float dot12 = (v1_0 * v2_0) + (v1_1 * v2_1);
-        
-        float invDenom = 1 / (dot00 * dot11 - dot01 * dot01);
-        
-        float u = (dot11 * dot02 - dot01 * dot12) * invDenom;
-        float v = (dot00 * dot12 - dot01 * dot02) * invDenom;
-        
-        return ((u >= 0) && (v >= 0) && (u + v < 1));
-    }
-    
     tapkee::TapkeeOutput doDimensionalityReduction(tapkee::DenseMatrix inputData, int outDimensions, const String& methodName)
     {
         #if JUCE_DEBUG
@@ -472,29 +732,33 @@ private:
         if (methodName == DIMENSIONALITY_REDUCTION_METHOD_TSNE){
             output = tapkee::initialize()
             .withParameters((tapkee::method=tapkee::tDistributedStochasticNeighborEmbedding,
-                             tapkee::target_dimension=outDimensions))
+                             tapkee::target_dimension=outDimensions,
+                             tapkee::cancel_function=&isComputationCancelled))
             .embedUsing(inputData);
         } else if (methodName == DIMENSIONALITY_REDUCTION_METHOD_MDS){
            output = tapkee::initialize()
             .withParameters((tapkee::method=tapkee::MultidimensionalScaling,
-                             tapkee::target_dimension=outDimensions))
+                             tapkee::target_dimension=outDimensions,
+                             tapkee::cancel_function=&isComputationCancelled))
             .embedUsing(inputData);
         } else if (methodName == DIMENSIONALITY_REDUCTION_METHOD_PCA){
             output = tapkee::initialize()
             .withParameters((tapkee::method=tapkee::PCA,
-                             tapkee::target_dimension=outDimensions))
+                             tapkee::target_dimension=outDimensions,
+                             tapkee::cancel_function=&isComputationCancelled))
             .embedUsing(inputData);
         } else {
             // Use PCA by default
             output = tapkee::initialize()
             .withParameters((tapkee::method=tapkee::PCA,
-                             tapkee::target_dimension=outDimensions))
+                             tapkee::target_dimension=outDimensions,
+                             tapkee::cancel_function=&isComputationCancelled))
             .embedUsing(inputData);
         }
         return output;
     }
     
-    ValueTree computeMapUsingMethod(timbreSpaceInputDataMatrix data, std::vector<int> presetIDXmap, const String& methodName)
+    void computeMapUsingMethod(timbreSpaceInputDataMatrix data, std::vector<int> presetIDXmap, const String& methodName, TimbreSpaceSolution& newSolution)
     {
         // NOTE: See computeMap documentation for details about input and output signatures of this function
         
@@ -520,6 +784,9 @@ private:
         }
         xx2D = normalizeFloatVector(xx2D);
         yy2D = normalizeFloatVector(yy2D);
+        if (isComputationCancelled()){
+            return;
+        }
         
         // Compute dimensionality reduction in 3D and normalize output
         tapkee::TapkeeOutput output3D = doDimensionalityReduction(inputData, 3, methodName);
@@ -533,21 +800,14 @@ private:
         xx3D = normalizeFloatVector(xx3D);
         yy3D = normalizeFloatVector(yy3D);
         zz3D = normalizeFloatVector(zz3D);
+        if (isComputationCancelled()){
+            return;
+        }
         
-        // Store results of in solution ValueTree (remove children if alreadye xisting)
-        ValueTree solutionPoints = ValueTree(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER);
+        // Store results in solution
         for (int i=0; i<N; i++){
-            ValueTree solutionPoint = ValueTree(TIMBRE_SPACE_SOLUTION_POINT_IDENTIFIER);
-            solutionPoint.setProperty("presetIdx", presetIDXmap[i], nullptr);
-            solutionPoint.setProperty("x", xx2D[i], nullptr);
-            solutionPoint.setProperty("y", yy2D[i], nullptr);
-            solutionPoint.setProperty("r", xx3D[i], nullptr);
-            solutionPoint.setProperty("g", yy3D[i], nullptr);
-            solutionPoint.setProperty("b", zz3D[i], nullptr);
-            solutionPoints.appendChild(solutionPoint, nullptr);
+            newSolution.addPoint(presetIDXmap[i], xx2D[i], yy2D[i], xx3D[i], yy3D[i], zz3D[i]);
         }
-        
-        return solutionPoints;
     }
     
     PresetDistancePairsToInterpolate getInterpolationDataForPointUsingTriangulation()
@@ -574,6 +834,63 @@ private:
         return interpolationData;
     }
     
+    PresetDistancePairsToInterpolate getInterpolationDataForPointUsingRaster()
+    {
+        /*
+         Returns PresetDistancePairsToInterpolate for the selected point from the interpolation raster. Data is the same
+         as returned by getInterpolationDataForPointUsingTriangulation for the centre of the raster cell, except that
+         presetDist contains the quantised interpolation weight (which is proportional to the distance).
+         */
+        
+        int cell = interpolationRaster.getCellIndex(selectedPointX, selectedPointY);
+        selectedTriangleIdx = interpolationRaster.getTriangleIdx(cell);
+        
+        PresetDistancePairsToInterpolate interpolationData;
+        for (int i=0; i<3; i++){
+            int pointIdx = interpolationRaster.getPointIdx(cell, i);
+            if (pointIdx > -1){
+                PresetDistanceStruct pd;
+                pd.presetIdx = solution.presetIdx[pointIdx];
+                pd.pointIdx = pointIdx;
+                pd.presetDist = interpolationRaster.getWeight(cell, i);
+                interpolationData.push_back(pd);
+            }
+        }
+        return interpolationData;
+    }
+    
+    PresetDistancePairsToInterpolate getInterpolationDataForNearestPreset()
+    {
+        /*
+         Returns PresetDistancePairsToInterpolate with only the preset nearest to the selected point, and moves the selected
+         point to the position of that preset in the space.
+         */
+        
+        int pointIdx = -1;
+        if (interpolationRaster.isBuilt()){
+            pointIdx = interpolationRaster.getNearestPointIdx(interpolationRaster.getCellIndex(selectedPointX, selectedPointY));
+        } else {
+            std::vector<std::pair<float, int>> nearest;
+            pointLocator.findNearestPoints(selectedPointX, selectedPointY, 1, nearest);
+            if (nearest.size() > 0){
+                pointIdx = nearest[0].second;
+            }
+        }
+        
+        PresetDistancePairsToInterpolate interpolationData;
+        if (pointIdx > -1){
+            selectedPointX = solution.x[pointIdx];
+            selectedPointY = solution.y[pointIdx];
+            selectedPresetPointIdx = pointIdx;
+            PresetDistanceStruct pd;
+            pd.presetIdx = solution.presetIdx[pointIdx];
+            pd.pointIdx = pointIdx;
+            pd.presetDist = 1.0f;
+            interpolationData.push_back(pd);
+        }
+        return interpolationData;
+    }
+    
     PresetDistancePairsToInterpolate getInterpolationDataForPointUsingNN(int N)
     {
         /*
@@ -581,23 +898,17 @@ private:
          Does not take input parameters as uses class members to get information about selected point and other necessary data.
          */
 
-        // Calculate distances with all points
-        std::vector<std::pair<float, int>> distances;
-        for (int i=0; i<solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getNumChildren(); i++){
-            ValueTree point = solution.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER).getChild(i);
-            float distance =  euclideanDistance(selectedPointX, selectedPointY, (float)point["x"], (float)point["y"]);
-            distances.emplace_back(distance, (int)point["presetIdx"]);
-        }
-        
-        // Sort points by distance
-        std::sort(distances.begin(), distances.end());
+        // Find the N nearest neighbours (sorted by distance) using the point locator grid
+        std::vector<std::pair<float, int>> nearest;
+        pointLocator.findNearestPoints(selectedPointX, selectedPointY, N, nearest);
         
-        // Take the N first points (the N nearest neighbours) and add to PresetDistancePairsToInterpolate
+        // Add them to PresetDistancePairsToInterpolate
         PresetDistancePairsToInterpolate interpolationData;
-        for (int i=0; i<N; i++){
+        for (int i=0; i<nearest.size(); i++){
             PresetDistanceStruct pd;
-            pd.presetIdx = distances[i].second;
-            pd.presetDist = distances[i].first;
+            pd.presetIdx = solution.presetIdx[nearest[i].second];
+            pd.pointIdx = nearest[i].second;
+            pd.presetDist = nearest[i].first;
             interpolationData.push_back(pd);
         }
     
@@ -0,0 +1,232 @@
+//
+//  TimbreSpaceInterpolationRaster.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "TimbreSpaceSolution.h"
+#include "TimbreSpacePointLocator.h"
+
+class TimbreSpaceInterpolationRaster
+
+{
+public:
+    /*
+     TimbreSpaceInterpolationRaster precomputes the interpolation data of every position of the timbre space
+     on a square grid of cells covering the normalized [0-1] space, so that resolving a selected point is a
+     table fetch. For the centre of each cell it stores:
+     - the index of the triangle that contains it (or -1 if it is outside the triangulation)
+     - the 3 points to interpolate (triangle vertices or 3 nearest neighbours) and their interpolation
+       weights (distance to the cell centre divided by the total distance, as in
+       DDRMInterface::getSynthControlIndexValuePairsForInterpolatedPresets) quantised to 16 bits
+     - the nearest point (used to snap to the nearest preset and to draw Voronoi regions)
+
+     Rows are computed in parallel in a thread pool which only exists while building, and build only returns once
+     all rows are done. Building takes some time, so TimbreSpaceEngine builds rasters in its background worker and
+     swaps them in when done (see swap). The raster must be rebuilt every time the solution changes; getBuildCount
+     can be used to detect that.
+     */
+
+    TimbreSpaceInterpolationRaster ()
+    {
+        size = 0;
+        buildCount = 0;
+    }
+
+    ~TimbreSpaceInterpolationRaster ()
+    {
+    }
+
+    bool build (const TimbreSpaceSolution& solution, const TimbreSpacePointLocator& locator, int rasterSize, bool (*isCancelled)() = nullptr)
+    {
+        // Returns false (and leaves the raster cleared) if the solution has no points or isCancelled returned true
+        // while building. isCancelled is called from the thread calling build.
+        clear();
+        if (!solution.hasPoints() || (rasterSize <= 0)){
+            return false;
+        }
+
+        size = rasterSize;
+        int numCells = size * size;
+        triangleIdxs.assign(numCells, -1);
+        pointIdxs.assign(numCells * 3, -1);
+        weights.assign(numCells * 3, 0);
+        nearestPointIdxs.assign(numCells, -1);
+
+        // Split rows in bands (more bands than threads so that threads finishing early pick up more work)
+        ThreadPool buildPool (jmax(1, SystemStats::getNumCpus()));
+        OwnedArray<BuildRowsJob> jobs;  // Declared after buildPool so jobs are deleted before it
+        int numJobs = jmin(size, buildPool.getNumThreads() * TIMBRE_SPACE_RASTER_JOBS_PER_THREAD);
+        for (int i=0; i<numJobs; i++){
+            jobs.add(new BuildRowsJob(*this, solution, locator, i * size / numJobs, (i + 1) * size / numJobs));
+            buildPool.addJob(jobs.getLast(), false);
+        }
+        for (int i=0; i<jobs.size(); i++){
+            while (!buildPool.waitForJobToFinish(jobs[i], TIMBRE_SPACE_RASTER_CANCEL_CHECK_INTERVAL_MS)){
+                if ((isCancelled != nullptr) && isCancelled()){
+                    buildPool.removeAllJobs(true, -1);
+                    clear();
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void swap (TimbreSpaceInterpolationRaster& other)
+    {
+        // Exchanges the contents of two rasters (e.g. to load a raster built in another thread), both count as rebuilt
+        std::swap(size, other.size);
+        triangleIdxs.swap(other.triangleIdxs);
+        pointIdxs.swap(other.pointIdxs);
+        weights.swap(other.weights);
+        nearestPointIdxs.swap(other.nearestPointIdxs);
+        buildCount++;
+        other.buildCount++;
+    }
+
+    void clear ()
+    {
+        size = 0;
+        triangleIdxs.clear();
+        pointIdxs.clear();
+        weights.clear();
+        nearestPointIdxs.clear();
+        buildCount++;
+    }
+
+    bool isBuilt () const
+    {
+        return size > 0;
+    }
+
+    int getSize () const
+    {
+        return size;
+    }
+
+    uint32 getBuildCount () const
+    {
+        // Changes every time the raster is built or cleared
+        return buildCount;
+    }
+
+    int getCellIndex (float x, float y) const
+    {
+        // Cell for a point in the normalized [0-1] space (points outside the space go to the nearest border cell)
+        int column = jlimit(0, size - 1, (int)std::floor(x * size));
+        int row = jlimit(0, size - 1, (int)std::floor(y * size));
+        return row * size + column;
+    }
+
+    int getTriangleIdx (int cell) const
+    {
+        return triangleIdxs[cell];
+    }
+
+    int getPointIdx (int cell, int i) const
+    {
+        // i-th point to interpolate (0-2), -1 if the solution has less than i + 1 points
+        return pointIdxs[3 * cell + i];
+    }
+
+    float getWeight (int cell, int i) const
+    {
+        return weights[3 * cell + i] / TIMBRE_SPACE_RASTER_WEIGHT_SCALE;
+    }
+
+    int getNearestPointIdx (int cell) const
+    {
+        return nearestPointIdxs[cell];
+    }
+
+private:
+
+    class BuildRowsJob: public ThreadPoolJob
+    {
+    public:
+        BuildRowsJob (TimbreSpaceInterpolationRaster& r, const TimbreSpaceSolution& s, const TimbreSpacePointLocator& l, int first, int last)
+            : ThreadPoolJob ("Timbre space raster rows"), raster (r), solution (s), locator (l), firstRow (first), lastRow (last)
+        {
+        }
+
+        JobStatus runJob () override
+        {
+            raster.buildRows(solution, locator, firstRow, lastRow, *this);
+            return jobHasFinished;
+        }
+
+    private:
+        TimbreSpaceInterpolationRaster& raster;
+        const TimbreSpaceSolution& solution;
+        const TimbreSpacePointLocator& locator;
+        int firstRow;
+        int lastRow;
+    };
+
+    int size;  // Number of rows and columns
+    uint32 buildCount;
+    std::vector<int32> triangleIdxs;
+    std::vector<int32> pointIdxs;  // 3 per cell
+    std::vector<uint16> weights;  // 3 per cell
+    std::vector<int32> nearestPointIdxs;
+
+    void buildRows (const TimbreSpaceSolution& solution, const TimbreSpacePointLocator& locator, int firstRow, int lastRow, const ThreadPoolJob& job)
+    {
+        // Computes the cells of rows firstRow to lastRow - 1 (called from the build pool threads, each with its own rows)
+        // Stops early if the job is asked to exit (the build is then cancelled)
+        std::vector<std::pair<float, int>> nearest;
+        for (int row=firstRow; row<lastRow; row++){
+            if (job.shouldExit()){
+                return;
+            }
+            float y = (row + 0.5f) / size;
+            for (int column=0; column<size; column++){
+                float x = (column + 0.5f) / size;
+                int cell = row * size + column;
+
+                locator.findNearestPoints(x, y, 3, nearest);
+                nearestPointIdxs[cell] = nearest[0].second;
+
+                // Same method as TimbreSpaceEngine::getInterpolationDataForPointUsingTriangulation: triangle vertices if
+                // the point is inside a triangle, 3 nearest neighbours otherwise
+                float distances[3] = {0.0f, 0.0f, 0.0f};
+                int numPoints = 0;
+                int triangleIdx = locator.findTriangle(x, y);
+                triangleIdxs[cell] = triangleIdx;
+                if (triangleIdx > -1){
+                    for (int i=0; i<3; i++){
+                        uint32 pointIdx = solution.triangles[3 * triangleIdx + i];
+                        float dx = x - solution.x[pointIdx];
+                        float dy = y - solution.y[pointIdx];
+                        pointIdxs[3 * cell + i] = (int32)pointIdx;
+                        distances[i] = std::sqrt(dx * dx + dy * dy);
+                    }
+                    numPoints = 3;
+                } else {
+                    for (int i=0; i<nearest.size(); i++){
+                        pointIdxs[3 * cell + i] = nearest[i].second;
+                        distances[i] = nearest[i].first;
+                    }
+                    numPoints = (int)nearest.size();
+                }
+
+                float totalDistance = distances[0] + distances[1] + distances[2];
+                for (int i=0; i<numPoints; i++){
+                    float weight = (totalDistance > 0.0f) ? distances[i] / totalDistance : 1.0f / numPoints;
+                    weights[3 * cell + i] = (uint16)roundToInt(weight * TIMBRE_SPACE_RASTER_WEIGHT_SCALE);
+                }
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TimbreSpaceInterpolationRaster)
+};
@@ -0,0 +1,271 @@
+//
+//  TimbreSpacePointLocator.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "TimbreSpaceSolution.h"
+
+class TimbreSpacePointLocator
+
+{
+public:
+    /*
+     TimbreSpacePointLocator answers point location queries on a TimbreSpaceSolution in constant expected time
+     (instead of scanning all triangles or sorting all points):
+     - findTriangle: index of the triangle that contains a point
+     - findNearestPoints: the k points nearest to a given point
+
+     It uses a uniform grid over the bounding box of the solution points with about one point per cell. Each
+     cell lists the triangles whose bounding box overlaps it and the points it contains. Lists are stored
+     contiguously (one offsets array and one indexes array per kind) so queries only touch a few cache lines.
+
+     The locator keeps a pointer to the solution it was built for, so build must be called again every time
+     that solution changes.
+     */
+
+    TimbreSpacePointLocator ()
+    {
+        solution = nullptr;
+        gridSize = 0;
+        minX = minY = 0.0f;
+        cellWidth = cellHeight = 1.0f;
+    }
+
+    ~TimbreSpacePointLocator ()
+    {
+    }
+
+    void build (const TimbreSpaceSolution* s)
+    {
+        solution = s;
+        gridSize = 0;
+        triangleCellStarts.clear();
+        triangleCellIdxs.clear();
+        pointCellStarts.clear();
+        pointCellIdxs.clear();
+        if ((solution == nullptr) || !solution->hasPoints()){
+            return;
+        }
+
+        // Grid over the bounding box of the points (with about one point per cell)
+        int numPoints = solution->getNumPoints();
+        minX = *std::min_element(solution->x.begin(), solution->x.end());
+        minY = *std::min_element(solution->y.begin(), solution->y.end());
+        float maxX = *std::max_element(solution->x.begin(), solution->x.end());
+        float maxY = *std::max_element(solution->y.begin(), solution->y.end());
+        gridSize = jlimit(1, TIMBRE_SPACE_LOCATOR_MAX_GRID_SIZE, (int)std::ceil(std::sqrt((float)numPoints)));
+        cellWidth = jmax(maxX - minX, TIMBRE_SPACE_LOCATOR_MIN_CELL_SIZE * gridSize) / gridSize;
+        cellHeight = jmax(maxY - minY, TIMBRE_SPACE_LOCATOR_MIN_CELL_SIZE * gridSize) / gridSize;
+
+        // Bucket points
+        std::vector<int> pointCells (numPoints);
+        std::vector<int> pointIdxs (numPoints);
+        for (int i=0; i<numPoints; i++){
+            pointCells[i] = getCellIndex(getCellColumn(solution->x[i]), getCellRow(solution->y[i]));
+        }
+        std::iota(pointIdxs.begin(), pointIdxs.end(), 0);
+        fillBuckets(pointCells, pointIdxs, pointCellStarts, pointCellIdxs);
+
+        // Bucket triangles in all cells overlapped by their bounding box
+        std::vector<int> triangleCells;
+        std::vector<int> triangleIdxs;
+        for (int i=0; i<solution->getNumTriangles(); i++){
+            const uint32* points = &solution->triangles[3 * i];
+            int firstColumn = getCellColumn(jmin(solution->x[points[0]], solution->x[points[1]], solution->x[points[2]]));
+            int lastColumn = getCellColumn(jmax(solution->x[points[0]], solution->x[points[1]], solution->x[points[2]]));
+            int firstRow = getCellRow(jmin(solution->y[points[0]], solution->y[points[1]], solution->y[points[2]]));
+            int lastRow = getCellRow(jmax(solution->y[points[0]], solution->y[points[1]], solution->y[points[2]]));
+            for (int row=firstRow; row<=lastRow; row++){
+                for (int column=firstColumn; column<=lastColumn; column++){
+                    triangleCells.push_back(getCellIndex(column, row));
+                    triangleIdxs.push_back(i);
+                }
+            }
+        }
+        fillBuckets(triangleCells, triangleIdxs, triangleCellStarts, triangleCellIdxs);
+    }
+
+    int findTriangle (float x, float y) const
+    {
+        // Returns the index of the triangle containing the point or -1 if the point is not inside any triangle.
+        // If the point is inside more than one triangle (e.g. on a shared edge), the highest index is returned.
+        if ((gridSize == 0) || !isInGrid(x, y)){
+            return -1;
+        }
+        int cell = getCellIndex(getCellColumn(x), getCellRow(y));
+        const float* xx = solution->x.data();
+        const float* yy = solution->y.data();
+        for (int i=triangleCellStarts[cell + 1] - 1; i>=triangleCellStarts[cell]; i--){  // Triangle indexes are sorted
+            const uint32* points = &solution->triangles[3 * triangleCellIdxs[i]];
+            if (isInTriangle(x, y, xx[points[0]], yy[points[0]], xx[points[1]], yy[points[1]], xx[points[2]], yy[points[2]])){
+                return triangleCellIdxs[i];
+            }
+        }
+        return -1;
+    }
+
+    void findNearestPoints (float x, float y, int k, std::vector<std::pair<float, int>>& nearest) const
+    {
+        // Fills nearest with the (distance, point index) pairs of the k points nearest to (x, y), sorted by distance
+        nearest.clear();
+        if (gridSize == 0){
+            return;
+        }
+        k = jmin(k, solution->getNumPoints());
+        if (k <= 0){
+            return;
+        }
+
+        // Visit rings of cells around the cell of the query point until k points have been found and no point outside
+        // the visited cells can be nearer than the k-th nearest point found
+        int centerColumn = getCellColumn(x);
+        int centerRow = getCellRow(y);
+        for (int ring=0; ; ring++){
+            int firstColumn = centerColumn - ring;
+            int lastColumn = centerColumn + ring;
+            int firstRow = centerRow - ring;
+            int lastRow = centerRow + ring;
+            for (int row=jmax(0, firstRow); row<=jmin(gridSize - 1, lastRow); row++){
+                bool isBorderRow = (row == firstRow) || (row == lastRow);
+                for (int column=jmax(0, firstColumn); column<=jmin(gridSize - 1, lastColumn); column++){
+                    if (isBorderRow || (column == firstColumn) || (column == lastColumn)){
+                        addCellPoints(getCellIndex(column, row), x, y, nearest);
+                    }
+                }
+            }
+
+            bool coversGrid = (firstColumn <= 0) && (firstRow <= 0) && (lastColumn >= gridSize - 1) && (lastRow >= gridSize - 1);
+            if ((int)nearest.size() >= k){
+                std::nth_element(nearest.begin(), nearest.begin() + (k - 1), nearest.end());
+                if (coversGrid || (nearest[k - 1].first < getDistanceToOutsideOfCells(x, y, firstColumn, lastColumn, firstRow, lastRow))){
+                    break;
+                }
+            } else if (coversGrid){
+                break;
+            }
+        }
+        nearest.resize(k);
+        std::sort(nearest.begin(), nearest.end());
+    }
+
+    static bool isInTriangle (float px, float py, float ax, float ay, float bx, float by, float cx, float cy)
+    {
+        // Target point (px, py)
+        // Triangle coodinates (ax, ay), (bx, by), (cx, cy)
+        //credit: http://www.blackpawn.com/texts/pointinpoly/default.html
+
+        float v0_0 = cx - ax;
+        float v0_1 = cy - ay;
+        float v1_0 = bx - ax;
+        float v1_1 = by - ay;
+        float v2_0 = px - ax;
+        float v2_1 = py - ay;
+
+        float dot00 = (v0_0 * v0_0) + (v0_1 * v0_1);
+        float dot01 = (v0_0 * v1_0) + (v0_1 * v1_1);
+        float dot02 = (v0_0 * v2_0) + (v0_1 * v2_1);
+        float dot11 = (v1_0 * v1_0) + (v1_1 * v1_1);
+        float dot12 = (v1_0 * v2_0) + (v1_1 * v2_1);
+
+        float invDenom = 1 / (dot00 * dot11 - dot01 * dot01);
+
+        float u = (dot11 * dot02 - dot01 * dot12) * invDenom;
+        float v = (dot00 * dot12 - dot01 * dot02) * invDenom;
+
+        return ((u >= 0) && (v >= 0) && (u + v < 1));
+    }
+
+private:
+
+    const TimbreSpaceSolution* solution;
+    int gridSize;  // Number of rows and columns
+    float minX;
+    float minY;
+    float cellWidth;
+    float cellHeight;
+    std::vector<int> triangleCellStarts;  // Triangles of cell i are triangleCellIdxs[triangleCellStarts[i]...triangleCellStarts[i + 1] - 1]
+    std::vector<int> triangleCellIdxs;
+    std::vector<int> pointCellStarts;  // Same for points
+    std::vector<int> pointCellIdxs;
+
+    int getCellColumn (float x) const
+    {
+        return jlimit(0, gridSize - 1, (int)std::floor((x - minX) / cellWidth));
+    }
+
+    int getCellRow (float y) const
+    {
+        return jlimit(0, gridSize - 1, (int)std::floor((y - minY) / cellHeight));
+    }
+
+    int getCellIndex (int column, int row) const
+    {
+        return row * gridSize + column;
+    }
+
+    bool isInGrid (float x, float y) const
+    {
+        return (x >= minX) && (y >= minY) && (x <= minX + gridSize * cellWidth) && (y <= minY + gridSize * cellHeight);
+    }
+
+    void fillBuckets (const std::vector<int>& cells, const std::vector<int>& idxs, std::vector<int>& cellStarts, std::vector<int>& cellIdxs)
+    {
+        // Counting sort of idxs by cell (idxs of the same cell keep their order)
+        cellStarts.assign(gridSize * gridSize + 1, 0);
+        for (int i=0; i<cells.size(); i++){
+            cellStarts[cells[i] + 1]++;
+        }
+        for (int i=0; i<gridSize * gridSize; i++){
+            cellStarts[i + 1] += cellStarts[i];
+        }
+        cellIdxs.resize(idxs.size());
+        std::vector<int> nextPositions (cellStarts.begin(), cellStarts.end() - 1);
+        for (int i=0; i<cells.size(); i++){
+            cellIdxs[nextPositions[cells[i]]++] = idxs[i];
+        }
+    }
+
+    void addCellPoints (int cell, float x, float y, std::vector<std::pair<float, int>>& candidates) const
+    {
+        for (int i=pointCellStarts[cell]; i<pointCellStarts[cell + 1]; i++){
+            int pointIdx = pointCellIdxs[i];
+            float dx = x - solution->x[pointIdx];
+            float dy = y - solution->y[pointIdx];
+            candidates.emplace_back(std::sqrt(dx * dx + dy * dy), pointIdx);
+        }
+    }
+
+    float getDistanceToOutsideOfCells (float x, float y, int firstColumn, int lastColumn, int firstRow, int lastRow) const
+    {
+        // Min distance from (x, y) to any point not in the given block of cells (sides of the block beyond the grid
+        // are ignored as there are no points there)
+        float distance = std::numeric_limits<float>::max();
+        if (firstColumn > 0){
+            distance = jmin(distance, x - (minX + firstColumn * cellWidth));
+        }
+        if (lastColumn < gridSize - 1){
+            distance = jmin(distance, minX + (lastColumn + 1) * cellWidth - x);
+        }
+        if (firstRow > 0){
+            distance = jmin(distance, y - (minY + firstRow * cellHeight));
+        }
+        if (lastRow < gridSize - 1){
+            distance = jmin(distance, minY + (lastRow + 1) * cellHeight - y);
+        }
+        return jmax(0.0f, distance);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TimbreSpacePointLocator)
+};
@@ -0,0 +1,168 @@
+//
+//  TimbreSpaceSolution.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+
+class TimbreSpaceSolution
+
+{
+public:
+    /*
+     TimbreSpaceSolution holds the map points and triangulation of a timbre space as flat arrays (structure of
+     arrays) so that point location, interpolation and drawing loops run over contiguous memory:
+     - x, y: normalized [0-1] position of each point in the space
+     - r, g, b: normalized [0-1] colour of each point (3D embedding of the presets)
+     - presetIdx: index of the preset in the bank to which each point corresponds
+     - triangles: 3 point indexes per triangle (as returned by delaunator)
+     - halfedges: for each triangle edge (triangles index), the index of the opposite edge in the adjacent
+       triangle, or -1 if the edge is on the convex hull
+
+     ValueTree representations are only used to save the solution in (and load it from) the plugin state. The
+     format is the same as the one used before flat arrays were introduced so old states can still be loaded.
+     */
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> r;
+    std::vector<float> g;
+    std::vector<float> b;
+    std::vector<int> presetIdx;
+    std::vector<uint32> triangles;
+    std::vector<int32> halfedges;
+
+    int getNumPoints () const
+    {
+        return (int)presetIdx.size();
+    }
+
+    int getNumTriangles () const
+    {
+        return (int)triangles.size() / 3;
+    }
+
+    bool hasPoints () const
+    {
+        return presetIdx.size() > 0;
+    }
+
+    bool hasTriangles () const
+    {
+        return triangles.size() > 0;
+    }
+
+    void clear ()
+    {
+        x.clear();
+        y.clear();
+        r.clear();
+        g.clear();
+        b.clear();
+        presetIdx.clear();
+        triangles.clear();
+        halfedges.clear();
+    }
+
+    void addPoint (int pointPresetIdx, float pointX, float pointY, float pointR, float pointG, float pointB)
+    {
+        presetIdx.push_back(pointPresetIdx);
+        x.push_back(pointX);
+        y.push_back(pointY);
+        r.push_back(pointR);
+        g.push_back(pointG);
+        b.push_back(pointB);
+    }
+
+    void computeHalfedges ()
+    {
+        // Rebuilds halfedges from triangles (used when triangles come from a saved state or the solution cache)
+        halfedges.assign(triangles.size(), -1);
+        std::unordered_map<uint64, int32> edges;
+        edges.reserve(triangles.size());
+        for (int e=0; e<triangles.size(); e++){
+            uint32 start = triangles[e];
+            uint32 end = triangles[(e % 3 == 2) ? e - 2 : e + 1];
+            auto opposite = edges.find(((uint64)end << 32) | start);
+            if (opposite != edges.end()){
+                halfedges[e] = opposite->second;
+                halfedges[opposite->second] = e;
+                edges.erase(opposite);
+            } else {
+                edges[((uint64)start << 32) | end] = e;
+            }
+        }
+    }
+
+    ValueTree toValueTree () const
+    {
+        ValueTree state = ValueTree(TIMBRE_SPACE_SOLUTION_IDENTIFIER);
+        ValueTree solutionPoints = ValueTree(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER);
+        for (int i=0; i<getNumPoints(); i++){
+            ValueTree solutionPoint = ValueTree(TIMBRE_SPACE_SOLUTION_POINT_IDENTIFIER);
+            solutionPoint.setProperty("presetIdx", presetIdx[i], nullptr);
+            solutionPoint.setProperty("x", x[i], nullptr);
+            solutionPoint.setProperty("y", y[i], nullptr);
+            solutionPoint.setProperty("r", r[i], nullptr);
+            solutionPoint.setProperty("g", g[i], nullptr);
+            solutionPoint.setProperty("b", b[i], nullptr);
+            solutionPoints.appendChild(solutionPoint, nullptr);
+        }
+        state.appendChild(solutionPoints, nullptr);
+
+        ValueTree solutionTriangles = ValueTree(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER);
+        for (int i=0; i<triangles.size(); i+=3){
+            ValueTree solutionTriangle = ValueTree(TIMBRE_SPACE_SOLUTION_TRIANGLE_IDENTIFIER);
+            solutionTriangle.setProperty("x1", x[triangles[i]], nullptr);
+            solutionTriangle.setProperty("y1", y[triangles[i]], nullptr);
+            solutionTriangle.setProperty("x2", x[triangles[i + 1]], nullptr);
+            solutionTriangle.setProperty("y2", y[triangles[i + 1]], nullptr);
+            solutionTriangle.setProperty("x3", x[triangles[i + 2]], nullptr);
+            solutionTriangle.setProperty("y3", y[triangles[i + 2]], nullptr);
+            solutionTriangle.setProperty("preset1Idx", (int)triangles[i], nullptr);
+            solutionTriangle.setProperty("preset2Idx", (int)triangles[i + 1], nullptr);
+            solutionTriangle.setProperty("preset3Idx", (int)triangles[i + 2], nullptr);
+            solutionTriangles.appendChild(solutionTriangle, nullptr);
+        }
+        state.appendChild(solutionTriangles, nullptr);
+        return state;
+    }
+
+    void loadFromValueTree (ValueTree state)
+    {
+        // Triangles which refer to points not present in the state are dropped
+        clear();
+        ValueTree solutionPoints = state.getChildWithName(TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER);
+        for (int i=0; i<solutionPoints.getNumChildren(); i++){
+            ValueTree point = solutionPoints.getChild(i);
+            addPoint((int)point["presetIdx"], (float)point["x"], (float)point["y"], (float)point["r"], (float)point["g"], (float)point["b"]);
+        }
+
+        ValueTree solutionTriangles = state.getChildWithName(TIMBRE_SPACE_SOLUTION_TRIANGLES_IDENTIFIER);
+        for (int i=0; i<solutionTriangles.getNumChildren(); i++){
+            ValueTree triangle = solutionTriangles.getChild(i);
+            int pointIdxs[3] = {(int)triangle["preset1Idx"], (int)triangle["preset2Idx"], (int)triangle["preset3Idx"]};
+            if (isPointIdxValid(pointIdxs[0]) && isPointIdxValid(pointIdxs[1]) && isPointIdxValid(pointIdxs[2])){
+                for (int j=0; j<3; j++){
+                    triangles.push_back((uint32)pointIdxs[j]);
+                }
+            }
+        }
+        computeHalfedges();
+    }
+
+private:
+
+    bool isPointIdxValid (int pointIdx) const
+    {
+        return (pointIdx >= 0) && (pointIdx < getNumPoints());
+    }
+};
@@ -0,0 +1,236 @@
+//
+//  TimbreSpaceSolutionCache.h
+//  DDRMTimbreSpace
+//
+//  Created by Frederic Font Corbera on 16/10/2026.
+//  Copyright © 2019 Rita&AuroraAudio. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "defines.h"
+#include "TimbreSpaceSolution.h"
+
+class TimbreSpaceSolutionCache
+
+{
+public:
+    /*
+     TimbreSpaceSolutionCache stores computed timbre space solutions in a directory of the user application
+     data folder so that banks which have already been mapped don't need to be computed again.
+
+     Solutions are keyed by a SHA-256 hash of the cache version, the dimensionality reduction method and its
+     parameters, and the filtered input data of the engine (which is derived from the preset bytes of the bank,
+     together with the preset indexes that survived filtering). Each solution is stored in a compact binary file:
+     - header: magic number, cache version, number of points, number of triangles (int32 each)
+     - points: presetIdx (int32), x, y, r, g, b (float32 each)
+     - triangles: indexes of the 3 points (int32 each), halfedges are rebuilt when loading
+     All values are little endian. Files with a different version or an unexpected size are deleted when read.
+
+     The cache is limited to TIMBRE_SPACE_CACHE_MAX_BYTES. Reading a solution refreshes the modification time of
+     its file, and least recently used files are deleted when storing a solution makes the cache exceed the limit.
+
+     The cache is not thread safe, it is only used from the worker thread of TimbreSpaceEngine.
+     */
+
+    TimbreSpaceSolutionCache ()
+    {
+        cacheDirectory = File::getSpecialLocation(File::userApplicationDataDirectory)
+                             .getChildFile(JucePlugin_Manufacturer)
+                             .getChildFile(JucePlugin_Name)
+                             .getChildFile(TIMBRE_SPACE_CACHE_DIRECTORY_NAME);
+    }
+
+    ~TimbreSpaceSolutionCache ()
+    {
+    }
+
+    static String computeKey (const timbreSpaceInputDataMatrix& data, const std::vector<int>& presetIDXmap, const String& methodName, const String& methodParameters)
+    {
+        MemoryOutputStream stream;
+        stream.writeInt(TIMBRE_SPACE_CACHE_VERSION);
+        stream.writeString(methodName);
+        stream.writeString(methodParameters);
+        stream.writeInt((int)data.size());
+        for (int i=0; i<data.size(); i++){
+            stream.writeInt(presetIDXmap[i]);
+            stream.writeInt((int)data[i].size());
+            for (int j=0; j<data[i].size(); j++){
+                stream.writeFloat(data[i][j]);
+            }
+        }
+        return SHA256(stream.getData(), stream.getDataSize()).toHexString();
+    }
+
+    bool load (const String& key, TimbreSpaceSolution& cachedSolution)
+    {
+        // Fills cachedSolution with the cached solution for the given key. Returns false if not in cache.
+        File file = getFileForKey(key);
+        if (!file.existsAsFile()){
+            return false;
+        }
+
+        MemoryBlock fileContents;
+        if (!file.loadFileAsData(fileContents)){
+            return false;
+        }
+        if (!readSolution(fileContents, cachedSolution)){
+            // Old version or corrupted file
+            cachedSolution.clear();
+            file.deleteFile();
+            return false;
+        }
+        file.setLastModificationTime(Time::getCurrentTime());
+        return true;
+    }
+
+    bool store (const String& key, const TimbreSpaceSolution& solutionToStore)
+    {
+        // Writes the solution to the cache (replacing the file atomically) and removes least recently used files
+        // if the cache is over the size limit. Returns false if the solution could not be written.
+        if (!cacheDirectory.createDirectory()){
+            return false;
+        }
+
+        MemoryOutputStream stream;
+        writeSolution(solutionToStore, stream);
+
+        File file = getFileForKey(key);
+        TemporaryFile temporaryFile (file);
+        {
+            FileOutputStream output (temporaryFile.getFile());
+            if (output.failedToOpen()){
+                return false;
+            }
+            output.write(stream.getData(), stream.getDataSize());
+            output.flush();
+            if (output.getStatus().failed()){
+                return false;
+            }
+        }
+        if (!temporaryFile.overwriteTargetFileWithTemporary()){
+            return false;
+        }
+
+        trimToMaxSize(file);
+        return true;
+    }
+
+    void clear ()
+    {
+        for (auto& file: getCacheFiles()){
+            file.deleteFile();
+        }
+    }
+
+private:
+
+    File cacheDirectory;
+
+    File getFileForKey (const String& key)
+    {
+        return cacheDirectory.getChildFile(key + TIMBRE_SPACE_CACHE_FILE_EXTENSION);
+    }
+
+    Array<File> getCacheFiles ()
+    {
+        return cacheDirectory.findChildFiles(File::findFiles, false, String("*") + TIMBRE_SPACE_CACHE_FILE_EXTENSION);
+    }
+
+    void trimToMaxSize (const File& fileToKeep)
+    {
+        // Deletes least recently used files until the cache fits in TIMBRE_SPACE_CACHE_MAX_BYTES (the file which
+        // has just been stored is never deleted)
+        Array<File> files = getCacheFiles();
+        int64 totalSize = 0;
+        for (auto& file: files){
+            totalSize += file.getSize();
+        }
+        if (totalSize <= TIMBRE_SPACE_CACHE_MAX_BYTES){
+            return;
+        }
+
+        std::vector<File> filesByAge (files.begin(), files.end());
+        std::sort(filesByAge.begin(), filesByAge.end(), [](const File& a, const File& b){
+            return a.getLastModificationTime() < b.getLastModificationTime();
+        });
+        for (auto& file: filesByAge){
+            if (totalSize <= TIMBRE_SPACE_CACHE_MAX_BYTES){
+                break;
+            }
+            if (file == fileToKeep){
+                continue;
+            }
+            int64 fileSize = file.getSize();
+            if (file.deleteFile()){
+                totalSize -= fileSize;
+            }
+        }
+    }
+
+    static void writeSolution (const TimbreSpaceSolution& solutionToWrite, MemoryOutputStream& stream)
+    {
+        stream.writeInt(TIMBRE_SPACE_CACHE_MAGIC);
+        stream.writeInt(TIMBRE_SPACE_CACHE_VERSION);
+        stream.writeInt(solutionToWrite.getNumPoints());
+        stream.writeInt(solutionToWrite.getNumTriangles());
+        for (int i=0; i<solutionToWrite.getNumPoints(); i++){
+            stream.writeInt(solutionToWrite.presetIdx[i]);
+            stream.writeFloat(solutionToWrite.x[i]);
+            stream.writeFloat(solutionToWrite.y[i]);
+            stream.writeFloat(solutionToWrite.r[i]);
+            stream.writeFloat(solutionToWrite.g[i]);
+            stream.writeFloat(solutionToWrite.b[i]);
+        }
+        for (int i=0; i<solutionToWrite.triangles.size(); i++){
+            stream.writeInt((int)solutionToWrite.triangles[i]);
+        }
+    }
+
+    static bool readSolution (const MemoryBlock& data, TimbreSpaceSolution& cachedSolution)
+    {
+        // Returns false if data is not a solution written with the current cache version
+        const int headerSize = 4 * sizeof(int32);
+        const int pointSize = sizeof(int32) + 5 * sizeof(float);
+        const int triangleSize = 3 * sizeof(int32);
+        if ((int64)data.getSize() < headerSize){
+            return false;
+        }
+
+        MemoryInputStream stream (data, false);
+        if ((stream.readInt() != TIMBRE_SPACE_CACHE_MAGIC) || (stream.readInt() != TIMBRE_SPACE_CACHE_VERSION)){
+            return false;
+        }
+        int numPoints = stream.readInt();
+        int numTriangles = stream.readInt();
+        if ((numPoints <= 0) || (numTriangles < 0)
+            || ((int64)data.getSize() != headerSize + (int64)numPoints * pointSize + (int64)numTriangles * triangleSize)){
+            return false;
+        }
+
+        cachedSolution.clear();
+        for (int i=0; i<numPoints; i++){
+            int pointPresetIdx = stream.readInt();
+            float pointX = stream.readFloat();
+            float pointY = stream.readFloat();
+            float pointR = stream.readFloat();
+            float pointG = stream.readFloat();
+            float pointB = stream.readFloat();
+            cachedSolution.addPoint(pointPresetIdx, pointX, pointY, pointR, pointG, pointB);
+        }
+        for (int i=0; i<numTriangles * 3; i++){
+            int pointIdx = stream.readInt();
+            if ((pointIdx < 0) || (pointIdx >= numPoints)){
+                return false;
+            }
+            cachedSolution.triangles.push_back((uint32)pointIdx);
+        }
+        cachedSolution.computeHalfedges();
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TimbreSpaceSolutionCache)
+};
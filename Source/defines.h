@@ -20,36 +20,68 @@
 #define LOG_MIDI_IN 0
 
 #define REFRESH_MIDI_DEVICES_TIMER_INTERVAL_MS 1000  // Set to 0 to disable the timer
-#define MIDI_IN_SAME_CC_TIME_THRESHOLD_MS 25
+#define MIDI_ECHO_SLOTS_PER_CC 8  // Max number of expected echoes tracked per CC number (see DDRMExpectedEchoTracker)
+#define MIDI_ECHO_INITIAL_LATENCY_ESTIMATE_MS 20.0f
+#define MIDI_ECHO_LATENCY_SMOOTHING 0.125f
+#define MIDI_ECHO_WINDOW_LATENCY_FACTOR 3.0f  // Echo window is this factor times the estimated round trip latency
+#define MIDI_ECHO_WINDOW_MIN_MS 15
+#define MIDI_ECHO_WINDOW_MAX_MS 1000
+#define MIDI_ECHO_LOST_CHECK_INTERVAL_MS 20
+#define MIDI_ECHO_MAX_RESENDS 2  // Max number of times a lost message is resent
+#define MIDI_TRANSMITTER_QUEUE_SIZE 256  // Must be a power of 2 and >= 128 (only one entry per pending CC number)
+#define MIDI_TRANSMITTER_POLL_WAIT_MS 1  // Wait of the transmitter thread while messages are pending or may arrive without notification
+#define MIDI_TRANSMITTER_STOP_TIMEOUT_MS 1000
+#define MIDI_TRANSMITTER_PACER_MAX_BURST_BYTES 48  // Max number of bytes sent in a row after the link has been idle
+#define MIDI_TRANSMITTER_HOST_QUEUE_SIZE 512  // Must be a power of 2
+#define DEFAULT_HOST_MIDI_BUFFER_SIZE 2048  // Bytes preallocated for host MIDI messages in processBlock
+#define MIDI_CC_MESSAGE_NUM_BYTES 3
+
+#define MIDI_LINK_RATE_UNLIMITED 0  // Link rates in bytes per second
+#define MIDI_LINK_RATE_DIN 3125  // 31250 baud, 10 bits per byte (start + 8 data + stop)
+#define MIDI_LINK_RATE_USB 12000  // Conservative rate for the DDRM USB CC handler
+#define MIDI_LINK_RATE_MIN 300  // Lowest rate when backing off because of lost messages
+#define MIDI_LINK_RATE_LOSS_BACKOFF 0.75  // Rate is multiplied by this factor when messages are lost
+#define MIDI_LINK_RATE_RECOVERY_PER_SECOND 0.1  // Fraction of the link rate recovered per second after backing off
+
+#define AUTOMATION_CONTROL_RATE_DEFAULT_HZ 50  // Rate at which host automation is sent to the synth (see DDRMAutomationDecimator)
+#define AUTOMATION_SLEW_LIMIT_STEPS 8  // Max CC steps per control rate tick when slew limiting is enabled
+
+#define MORPH_TIMER_INTERVAL_MS 2  // Resolution at which morph trajectories are played (see DDRMMorphEngine)
+#define MORPH_DEFAULT_BPM 120.0  // Tempo used for morph durations until the host reports one
+#define MORPH_CURVE_INVERSION_ITERATIONS 20
+
+#define LEVEL_DETECTOR_ENVELOPE_DECAY_MS 20.0  // Decay time constant of the peak envelope of DDRMLevelChangeDetector
+#define SOUND_LATENCY_CALIBRATION_NUM_TRIALS 8
+#define SOUND_LATENCY_CALIBRATION_SETTLE_MS 500  // Time for the sound to settle after changing the level (also max wait for detection)
+#define SOUND_LATENCY_CALIBRATION_MEASURE_MS 300
+#define SOUND_LATENCY_CALIBRATION_MIN_LEVEL 0.01f  // Min input level (peak envelope) with channel levels at 127
+#define SOUND_LATENCY_CALIBRATION_MIN_LEVEL_RATIO 4.0f  // Min ratio between input levels with channel levels at 127 and 0
+
+#define MIDI_LINK_CALIBRATION_PROBE_RATE 300  // Rate (bytes per second) used to measure round trip time
+#define MIDI_LINK_CALIBRATION_NUM_PROBES 8
+#define MIDI_LINK_CALIBRATION_BURST_SIZE 96  // Number of messages sent to test each rate
+#define MIDI_LINK_CALIBRATION_ECHO_WAIT_MS 1000  // Max time to wait for the echoes of a burst
+#define MIDI_LINK_CALIBRATION_SAFETY_FACTOR 0.9  // Calibrated rate is the highest rate without losses times this factor
+
+#define TIMBRE_SPACE_CACHE_DIRECTORY_NAME "TimbreSpaceCache"  // Inside the plugin folder of the user application data directory
+#define TIMBRE_SPACE_CACHE_FILE_EXTENSION ".tss"
+#define TIMBRE_SPACE_CACHE_MAGIC 0x53535444  // "DTSS"
+#define TIMBRE_SPACE_CACHE_VERSION 1  // Increase when the file format or the computation of solutions changes (invalidates cached solutions)
+#define TIMBRE_SPACE_CACHE_MAX_BYTES (16 * 1024 * 1024)  // Least recently used solutions are deleted above this size
+#define TIMBRE_SPACE_LOCATOR_MAX_GRID_SIZE 128  // Max number of rows and columns of the point location grid (see TimbreSpacePointLocator)
+#define TIMBRE_SPACE_LOCATOR_MIN_CELL_SIZE 1e-6f  // Avoids empty cells when all points have the same x or y
+#define TIMBRE_SPACE_RASTER_SIZE 512  // Number of rows and columns of the interpolation raster (see TimbreSpaceInterpolationRaster)
+#define TIMBRE_SPACE_RASTER_JOBS_PER_THREAD 4
+#define TIMBRE_SPACE_RASTER_CANCEL_CHECK_INTERVAL_MS 10  // How often a raster build checks whether it has been cancelled
+#define TIMBRE_SPACE_RASTER_WEIGHT_SCALE 65535.0f  // Interpolation weights are quantised to 16 bits
+#define TIMBRE_SPACE_VORONOI_COLOUR 0x44FFFFFF
 
 #define DDRM_PRESET_NUM_BYTES 98
 #define DDRM_VOICE_NUM_BYTES 26
 
 #define EMPTY_PRESET_SUM_THRESHOLD 5.0
 
-#define ACTION_LOAD_TS_SOLUTION "ACTION_LOAD_TS_SOLUTION:"
-#define ACTION_SET_IS_COMPUTING_TS_SOLUTION "ACTION_SET_IS_COMPUTING_TS_SOLUTION:"
-#define ACTION_LOAD_SELECTED_POINT_DATA "ACTION_LOAD_SELECTED_POINT_DATA:"
-#define ACTION_REPAINT "ACTION_REPAINT:"
-#define ACTION_LOAD_INTERPOLATED_PRESET "ACTION_LOAD_INTERPOLATED_PRESET:"
-#define ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1_OFF "ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1_OFF:"
-#define ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2_OFF "ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2_OFF:"
-#define ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1 "ACTION_SET_TONE_SELECTOR_BUTTONS_ROW1"
-#define ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2 "ACTION_SET_TONE_SELECTOR_BUTTONS_ROW2"
-#define ACTION_SET_TS_SLIDERS_OUT_OF_SYNC "ACTION_SET_TS_SLIDERS_OUT_OF_SYNC:"
-#define ACTION_SET_TS_SLIDERS_IN_SYNC "ACTION_SET_TS_SLIDERS_IN_SYNC:"
-#define ACTION_SET_TS_XY_TO_PRESET_NUMBER "ACTION_SET_TS_XY_TO_PRESET_NUMBER:"
-#define ACTION_SET_CURRENT_PRESET_NAME "ACTION_SET_CURRENT_PRESET_NAME:"
-#define ACTION_SET_CURRENT_PRESET_NAME_OUT_OF_SYNC "ACTION_SET_CURRENT_PRESET_NAME_OUT_OF_SYNC:"
-#define ACTION_SET_CURRENT_PRESET_NAME_IN_SYNC "ACTION_SET_CURRENT_PRESET_NAME_IN_SYNC:"
-#define ACTION_CURRENT_PRESENT_SAVED_TO_BANK "ACTION_CURRENT_PRESENT_SAVED_TO_BANK"
-#define ACTION_BANK_FILE_LOADED "ACTION_BANK_FILE_LOADED:"
-#define ACTION_UPDATED_MIDI_DEVICE_SETTINGS "ACTION_UPDATED_MIDI_DEVICE_SETTINGS:"
-#define ACTION_REFRESH_MIDI_DEVICE_LISTS "ACTION_REFRESH_MIDI_DEVICE_LISTS:"
-#define ACTION_UPDATE_UI_SCALE_FACTOR "ACTION_UPDATE_UI_SCALE_FACTOR:"
-#define ACTION_MIDI_ENABLE_AUTO_SCAN "ACTION_MIDI_ENABLE_AUTO_SCAN"
-#define ACTION_MIDI_DISABLE_AUTO_SCAN "ACTION_MIDI_DISABLE_AUTO_SCAN"
-#define ACTION_MIDI_TRIGGER_DEVICE_SCAN "ACTION_MIDI_TRIGGER_DEVICE_SCAN"
+#define DDRM_EVENT_BUS_LISTENERS_PER_EVENT 8  // Preallocated listener slots per event type (see DDRMEventBus)
 
 #define PRESET_NAME_DEFAULT_TEXT "-"
 #define PRESET_NAME_MODIFIED_TEXT "*"
@@ -62,8 +94,8 @@
 #define SPACE_X_PARAMETER_NAME "Space X"
 #define SPACE_Y_PARAMETER_ID "space_y"
 #define SPACE_Y_PARAMETER_NAME "Space Y"
-#define MIN_MILLISECONDS_FOR_AUTOMATION_TIMBRE_SPACE_UPDATE 10
-#define MIN_MILLISECONDS_FOR_MOUSE_DRAG_UPDATE 0
+#define TIMBRE_SPACE_UPDATE_INTERVAL_MS 10  // Min interval between two interpolations when selecting points in the timbre space (mouse drag or automation)
+#define DEFERRED_PARAMETER_CHANGES_FLUSH_INTERVAL_MS 16  // Interval (~display rate) at which parameter changes from automation and MIDI input are applied in the message thread
 
 #define CS80COLOR_YELLOW 0xFFfffa0c
 #define CS80COLOR_WHITE 0xFFfafafa
@@ -92,6 +124,8 @@
 #define STATE_TIMBRE_SPACE_SELECTED_TRIANGLE_IDX_IDENTIFIER "selectedTriangleIdx"
 #define STATE_TIMBRE_SPACE_SELECTED_PRESET_IDX_IDENTIFIER "selectedPresetIdx"
 #define STATE_TIMBRE_SPACE_OUT_OF_SYNC "synthSlidersOutOfSync"
+#define STATE_TIMBRE_SPACE_INTERPOLATION_RASTER "interpolationRasterEnabled"
+#define STATE_TIMBRE_SPACE_SNAP_TO_NEAREST_PRESET "snapToNearestPreset"
 
 #define STATE_SELECTED_TONE_SELECTOR_ROW1 "toneSelectorRow1"
 #define STATE_SELECTED_TONE_SELECTOR_ROW2 "toneSelectorRow2"
@@ -101,6 +135,18 @@
 #define STATE_MIDI_INPUT_CHANNEL "midiInputChannel"
 #define STATE_MIDI_OUTPUT_CHANNEL "midiOutputChannel"
 #define STATE_MIDI_AUTOSCAN_ENABLED "midiDevicesAutoScanEnabled"
+#define STATE_MIDI_OUTPUT_LINK_RATE "midiOutputLinkRate"
+#define STATE_MIDI_OUTPUT_TO_HOST "midiOutputToHost"
+#define STATE_AUTOMATION_CONTROL_RATE "automationControlRate"
+#define STATE_AUTOMATION_SLEW_LIMIT "automationSlewLimit"
+#define STATE_PRESET_MORPH_BEATS "presetMorphBeats"
+#define STATE_PRESET_MORPH_CURVE "presetMorphCurve"
+#define STATE_MIDI_LINK_CALIBRATIONS_IDENTIFIER "MidiLinkCalibrations"
+#define STATE_MIDI_LINK_CALIBRATION_IDENTIFIER "MidiLinkCalibration"
+#define STATE_MIDI_LINK_CALIBRATION_DEVICE_NAME "deviceName"
+#define STATE_MIDI_LINK_CALIBRATION_BYTES_PER_SECOND "bytesPerSecond"
+#define STATE_MIDI_LINK_CALIBRATION_ROUND_TRIP_MS "roundTripMs"
+#define STATE_MIDI_LINK_CALIBRATION_SOUND_LATENCY_MS "soundLatencyMs"
 
 #define TIMBRE_SPACE_SOLUTION_IDENTIFIER "TimbreSpaceSolution"
 #define TIMBRE_SPACE_SOLUTION_POINTS_IDENTIFIER "solutionPoints"
@@ -152,6 +198,32 @@
 #define MENU_OPTION_MIDI_SET_AUTOSCAN_OFF 36
 #define MENU_OPTION_MIDI_SCAN_NOW 37
 
+#define MENU_OPTION_MIDI_LINK_RATE_DIN 38
+#define MENU_OPTION_MIDI_LINK_RATE_USB 39
+#define MENU_OPTION_MIDI_LINK_RATE_UNLIMITED 40
+#define MENU_OPTION_MIDI_LINK_CALIBRATE 41
+#define MENU_OPTION_MIDI_OUTPUT_TO_HOST_ON 42
+#define MENU_OPTION_MIDI_OUTPUT_TO_HOST_OFF 43
+
+#define MENU_OPTION_AUTOMATION_RATE_25 44
+#define MENU_OPTION_AUTOMATION_RATE_50 45
+#define MENU_OPTION_AUTOMATION_RATE_100 46
+#define MENU_OPTION_AUTOMATION_SLEW_ON 47
+#define MENU_OPTION_AUTOMATION_SLEW_OFF 48
+
+#define MENU_OPTION_PRESET_MORPH_OFF 49
+#define MENU_OPTION_PRESET_MORPH_1_BEAT 50
+#define MENU_OPTION_PRESET_MORPH_2_BEATS 51
+#define MENU_OPTION_PRESET_MORPH_4_BEATS 52
+#define MENU_OPTION_PRESET_MORPH_8_BEATS 53
+#define MENU_OPTION_PRESET_MORPH_EASE_ON 54
+#define MENU_OPTION_PRESET_MORPH_EASE_OFF 55
+#define MENU_OPTION_SOUND_LATENCY_CALIBRATE 56
+#define MENU_OPTION_TIMBRE_SPACE_RASTER_ON 57
+#define MENU_OPTION_TIMBRE_SPACE_RASTER_OFF 58
+#define MENU_OPTION_TIMBRE_SPACE_SNAP_ON 59
+#define MENU_OPTION_TIMBRE_SPACE_SNAP_OFF 60
+
 #define DIMENSIONALITY_REDUCTION_METHOD_PCA "pca"
 #define DIMENSIONALITY_REDUCTION_METHOD_TSNE "tsne"
 #define DIMENSIONALITY_REDUCTION_METHOD_MDS "mds"
@@ -162,13 +234,21 @@ typedef std::array<uint8, DDRM_VOICE_NUM_BYTES> DDRMVoiceBytes;
 typedef std::array<uint8, DDRM_PRESET_NUM_BYTES> DDRMPresetBytes;
 typedef std::pair<String, double> SynthControlIdValuePair;
 typedef std::vector<SynthControlIdValuePair> SynthControlIdValuePairs;
+typedef std::pair<int, double> SynthControlIndexValuePair;  // Synth control index in DDRMInterface, normalized value
+typedef std::vector<SynthControlIndexValuePair> SynthControlIndexValuePairs;
 
 typedef std::vector<std::vector<float>> timbreSpaceInputDataMatrix;
 
+struct CCDispatchEntry {
+    RangedAudioParameter* parameter;  // nullptr if no synth control is assigned to the CC number
+    int controlIndex;  // Index of the synth control in DDRMInterface, -1 if no synth control is assigned to the CC number
+};
+typedef std::array<CCDispatchEntry, 128> CCDispatchTable;
+
 struct PresetDistanceStruct {
-    int presetIdx;
+    int presetIdx;  // Index of the preset in the bank
+    int pointIdx;  // Index of the point of the preset in the timbre space solution
     float presetDist;
 };
 typedef std::vector<PresetDistanceStruct> PresetDistancePairsToInterpolate;
 
-typedef std::array<int64, 129> TimestampsLastCCSent; // Use 129 positions instead of 128 to not crash if using 1-indexed MIDI CC numbers (see docs in DdrmtimbreSpaceAudioProcessor::handleIncomingMidiMessage)